@@ -11,6 +11,12 @@ auto br = noarr::make_bag(sr, (void*)nullptr);
 _tmp_x = "noarr::array<'x', 42, noarr::scalar<float>>::signature"
 _tmp_y = _tmp_x.replace('x', 'y')
 
+_tmp_chunked = '''
+auto matrix = noarr::scalar<float>() ^ noarr::sized_vector<'j'>(1024) ^ noarr::sized_vector<'i'>(768)
+	^ noarr::into_blocks<'i', 'I', 'i'>(64) ^ noarr::into_blocks<'j', 'J', 'j'>(64);
+auto layout = noarr::chunk_layout<'I', 'J'>(matrix);
+'''
+
 global_decls = '''
 #include <../tests/noarr_test_cuda_dummy.hpp>
 #include <noarr/structures/interop/cuda_striped.cuh>
@@ -22,6 +28,7 @@ global_decls = '''
 #include <cstdlib>
 #include <cstdint>
 #include <cstring>
+#include <sstream>
 '''
 
 substitutions = {
@@ -42,15 +49,17 @@ substitutions = {
 	('docs/Traverser.md', 6): {'.*this fails.*': ''},
 	('docs/Traverser.md', 7): {'.*this fails.*': ''},
 	('docs/Traverser.md', 8): {'(from|a|b)_data': 'std::calloc(400*500, sizeof(float))'},
-	('docs/Traverser.md', 13): {'#pragma omp parallel for': ''},
 	('docs/Traverser.md', 14): {'#pragma omp parallel for': ''},
-	('docs/Traverser.md', 18): {
+	('docs/Traverser.md', 15): {'#pragma omp parallel for': ''},
+	('docs/Traverser.md', 20): {
 		'matrix_data': 'std::calloc(300*400, sizeof(float))',
 		f'(noarr::tbb_reduce_bag{_ANY}*,)({_ANY}*)noarr::tbb_reduce_bag.*,': lambda mo: ''.join(mo.group(1, 2, 1)),
 	},
-	('docs/Traverser.md', 19): {_PROLOG: 'void *values_data = nullptr; std::size_t size = 0;'},
-	('docs/Traverser.md', 21): {'[ab]_data': '(void*)nullptr'},
-	('docs/Traverser.md', 22): {'[ab]_data': '(void*)nullptr'},
+	('docs/Traverser.md', 21): {_PROLOG: 'void *values_data = nullptr; std::size_t size = 0;'},
+	('docs/Traverser.md', 23): {'[ab]_data': '(void*)nullptr'},
+	('docs/Traverser.md', 24): {'[ab]_data': '(void*)nullptr'},
+	('docs/other/Chunked.md', 2): {_PROLOG: _tmp_chunked},
+	('docs/other/Chunked.md', 3): {_PROLOG: _tmp_chunked + 'std::stringstream file; noarr::write_chunked(file, layout, noarr::make_bag(matrix).data()); noarr::chunked_reader reader(layout, file);'},
 	('docs/other/Functions.md', 0): {_PROLOG: "auto matrix = noarr::scalar<int>() ^ noarr::sized_vector<'x'>(1);", '.*(will not work|not make sense).*': ''},
 	('docs/other/Functions.md', 1): {_PROLOG: "auto matrix = noarr::scalar<int>() ^ noarr::sized_vector<'x'>(1);"},
 	('docs/other/Mangling.md', 0): {'/\*\.\.\.\*/': '0'},
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 namespace tbb {
 
 struct split {};
@@ -8,6 +10,17 @@ inline void parallel_for(const R &range, const F &f) {
 	f(range);
 }
 
+template<class Index, class F>
+inline void parallel_for(Index first, Index last, const F &f) {
+	for(; first < last; ++first)
+		f(first);
+}
+
+template<class RandomIt, class Compare>
+inline void parallel_sort(RandomIt first, RandomIt last, const Compare &comp) {
+	std::sort(first, last, comp);
+}
+
 template<class T>
 struct combinable {
 	T t;
@@ -0,0 +1,37 @@
+#ifndef NOARR_BENCHMARKS_BENCHMARK_HPP
+#define NOARR_BENCHMARKS_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// runs `f` once to warm up the caches, then `repeat` more times, and prints the average time of one run
+template<class F>
+void measure(const std::string &name, std::size_t repeat, F f)
+{
+	f();
+
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < repeat; i++)
+		f();
+	auto end = std::chrono::steady_clock::now();
+
+	std::chrono::duration<double, std::milli> elapsed = end - start;
+	std::cout << name << ": " << elapsed.count() / repeat << " ms" << std::endl;
+}
+
+// parses a positive integer argument, exits with the usage message if it is not one
+inline std::size_t parse_size(const char *arg, const char *usage)
+{
+	char *end;
+	unsigned long long value = std::strtoull(arg, &end, 10);
+	if (*arg == '\0' || *end != '\0' || value == 0)
+	{
+		std::cerr << usage << std::endl;
+		std::exit(1);
+	}
+	return (std::size_t)value;
+}
+
+#endif // NOARR_BENCHMARKS_BENCHMARK_HPP
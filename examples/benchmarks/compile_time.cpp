@@ -0,0 +1,115 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "benchmark.hpp"
+
+// Compiles the synthetic translation unit (compile_time_chain.cpp) with chains of the given depths,
+// and prints the compilation time, the peak memory of the compiler, and the template instantiation depth it needs
+
+static const char usage[] = "Usage: compile_time [chain depth]...";
+
+struct compilation
+{
+	bool success;
+	double seconds;
+	long max_rss_kib;
+};
+
+// runs the compiler on the chain of the given depth (with the extra arguments), its output is discarded
+static compilation compile(std::size_t depth, const std::vector<std::string> &extra_args)
+{
+	std::vector<std::string> args = {
+		NOARR_COMPILE_TIME_CXX, "-std=c++17", "-O2", "-I", NOARR_COMPILE_TIME_INCLUDE,
+		"-DNOARR_CHAIN_DEPTH=" + std::to_string(depth),
+	};
+	args.insert(args.end(), extra_args.begin(), extra_args.end());
+	args.push_back(NOARR_COMPILE_TIME_SOURCE);
+
+	std::vector<char *> argv;
+	for (auto &arg : args)
+		argv.push_back(arg.data());
+	argv.push_back(nullptr);
+
+	auto start = std::chrono::steady_clock::now();
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		std::perror("fork");
+		std::exit(1);
+	}
+	if (pid == 0)
+	{
+		int null_fd = open("/dev/null", O_WRONLY);
+		dup2(null_fd, STDOUT_FILENO);
+		dup2(null_fd, STDERR_FILENO);
+		execvp(argv[0], argv.data());
+		_exit(127);
+	}
+
+	int status;
+	struct rusage usage;
+	wait4(pid, &status, 0, &usage);
+	auto end = std::chrono::steady_clock::now();
+
+	std::chrono::duration<double> elapsed = end - start;
+	return {WIFEXITED(status) && WEXITSTATUS(status) == 0, elapsed.count(), usage.ru_maxrss};
+}
+
+// the smallest `-ftemplate-depth` with which the chain compiles (found by bisection), zero if none up to the limit
+static std::size_t template_depth(std::size_t depth)
+{
+	auto compiles = [depth](std::size_t limit)
+	{
+		return compile(depth, {"-fsyntax-only", "-ftemplate-depth=" + std::to_string(limit)}).success;
+	};
+
+	constexpr std::size_t max_limit = 1 << 14;
+	std::size_t high = 64;
+	while (high <= max_limit && !compiles(high))
+		high *= 2;
+	if (high > max_limit)
+		return 0;
+
+	std::size_t low = 0; // does not compile
+	while (high - low > 1)
+	{
+		std::size_t mid = low + (high - low) / 2;
+		if (compiles(mid))
+			high = mid;
+		else
+			low = mid;
+	}
+	return high;
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<std::size_t> depths;
+	for (int i = 1; i < argc; i++)
+		depths.push_back(parse_size(argv[i], usage));
+	if (depths.empty())
+		depths = {4, 8, 16, 24};
+
+	for (std::size_t depth : depths)
+	{
+		compilation c = compile(depth, {"-c", "-o", "/dev/null"});
+		if (!c.success)
+		{
+			std::cerr << "chain depth " << depth << ": compilation failed" << std::endl;
+			return 1;
+		}
+
+		std::cout << "chain depth " << depth << ": " << c.seconds << " s, " << c.max_rss_kib / 1024 << " MiB, template depth " << template_depth(depth) << std::endl;
+	}
+
+	return 0;
+}
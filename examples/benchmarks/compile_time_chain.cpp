@@ -0,0 +1,52 @@
+#include <cstddef>
+#include <iostream>
+#include <utility>
+
+#include "noarr/structures_extended.hpp"
+#include "noarr/structures/extra/traverser.hpp"
+
+// A synthetic translation unit for the compile_time benchmark: a structure composed of `NOARR_CHAIN_DEPTH` layers,
+// each one consisting of several protos, traversed with all the indices in one state
+
+#ifndef NOARR_CHAIN_DEPTH
+#define NOARR_CHAIN_DEPTH 8
+#endif
+
+static_assert(NOARR_CHAIN_DEPTH >= 1 && NOARR_CHAIN_DEPTH <= 60, "Unsupported depth");
+
+template<std::size_t I>
+constexpr char layer_dim = char('A' + I);
+
+template<std::size_t I>
+constexpr auto layer()
+{
+	constexpr char dim = layer_dim<I>;
+	return noarr::vector<'!'>() ^ noarr::set_length<'!'>(3) ^ noarr::rename<'!', dim>() ^ noarr::slice<dim>(1, 1);
+}
+
+template<std::size_t... I>
+constexpr auto chain(std::index_sequence<I...>)
+{
+	return (noarr::scalar<float>() ^ ... ^ layer<I>()) ^ noarr::hoist<layer_dim<0>>();
+}
+
+template<std::size_t... I>
+std::size_t run(std::index_sequence<I...> is)
+{
+	auto s = chain(is);
+	std::size_t sum = s | noarr::get_size();
+
+	noarr::traverser(s).for_each([&](auto state)
+	{
+		sum += s | noarr::offset(state);
+		sum += (s ^ noarr::fix(state.template remove<noarr::index_in<layer_dim<0>>>())) | noarr::get_length<layer_dim<0>>();
+	});
+
+	return sum;
+}
+
+int main()
+{
+	std::cout << run(std::make_index_sequence<NOARR_CHAIN_DEPTH>()) << std::endl;
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "noarr/structures_extended.hpp"
+#include "noarr/structures/extra/traverser.hpp"
+#include "noarr/structures/interop/bag.hpp"
+#include "noarr/structures/structs/pad.hpp"
+
+#include "benchmark.hpp"
+
+// Cache-associativity conflicts: the column sums of a matrix with power-of-two rows, with and without pad_stride
+
+static const char usage[] =
+	"Usage: conflict <plain|padded> <rows> <columns>\n"
+	"  plain:  the rows are stored one after another\n"
+	"  padded: the rows are padded to an odd number of cache lines (pad_stride)";
+
+// sums the columns: the inner loop goes down a column, so it touches one cache line per row
+template<class Matrix>
+double column_sums(const Matrix &matrix, std::vector<float> &sums)
+{
+	noarr::traverser(matrix).order(noarr::hoist<'j'>()).template for_dims<'j'>([&](auto outer)
+	{
+		float sum = 0;
+		outer.for_each([&](auto state) { sum += matrix[state]; });
+		sums[noarr::get_index<'j'>(outer.state())] = sum;
+	});
+
+	double checksum = 0;
+	for (float sum : sums)
+		checksum += sum;
+	return checksum;
+}
+
+template<class Structure>
+void run(const std::string &variant, Structure structure)
+{
+	auto matrix = noarr::make_bag(structure);
+	noarr::traverser(matrix).for_each([&](auto state)
+	{
+		auto i = noarr::get_index<'i'>(state), j = noarr::get_index<'j'>(state);
+		matrix[state] = (float)((i * 7 + j * 13) % 101);
+	});
+
+	std::vector<float> sums(matrix | noarr::get_length<'j'>());
+	double checksum = 0;
+	measure(variant + " column sums", 5, [&] { checksum = column_sums(matrix, sums); });
+
+	std::cout << "row size: " << (matrix.get_size() / (matrix | noarr::get_length<'i'>())) << " B" << std::endl;
+	std::cout << "checksum: " << checksum << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 4)
+	{
+		std::cerr << usage << std::endl;
+		return 1;
+	}
+
+	std::string variant = argv[1];
+	std::size_t rows = parse_size(argv[2], usage);
+	std::size_t columns = parse_size(argv[3], usage);
+
+	if (variant == "plain")
+		run(variant, noarr::scalar<float>() ^ noarr::vector<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(rows, columns));
+	else if (variant == "padded")
+		run(variant, noarr::scalar<float>() ^ noarr::vector<'j'>() ^ noarr::pad_stride<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(rows, columns));
+	else
+	{
+		std::cerr << usage << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "noarr/structures_extended.hpp"
+#include "noarr/structures/extra/shortcuts.hpp"
+#include "noarr/structures/extra/stencil.hpp"
+#include "noarr/structures/interop/bag.hpp"
+#include "noarr/structures/structs/zcurve.hpp"
+#ifdef NOARR_BENCHMARKS_TBB
+#include "noarr/structures/interop/tbb.hpp"
+#endif
+
+#include "benchmark.hpp"
+
+// Jacobi iteration: each interior element is replaced by the average of itself and its direct neighbors,
+// the boundary elements are kept as they are
+
+static const char usage[] =
+	"Usage: jacobi <2d|3d> <rows|zcurve|tiles|tbb> <size> <steps>\n"
+	"  rows:   the interior is traversed in the layout order (row-major)\n"
+	"  zcurve: the interior is traversed in the Z-order curve\n"
+	"  tiles:  the interior is traversed tile by tile\n"
+	"  tbb:    the tiles are traversed in parallel (only if built with TBB)";
+
+// the maximum length of one dimension for the Z-order curve traversal
+constexpr int zcurve_maxlen = 1 << 16;
+
+// the tiles are wide in the innermost dimension ('x') to keep the inner loops long enough for vectorization
+constexpr std::size_t tile_x = 512;
+constexpr std::size_t tile_y = 32;
+constexpr std::size_t tile_z = 16;
+
+template<class In, class Out>
+void step_2d(const std::string &variant, const In &in, const Out &out)
+{
+	auto t = noarr::traverser(in, out);
+	auto s = noarr::stencil<'x', 'y'>(1, 1);
+
+	auto kernel = [&](auto state)
+	{
+		out[state] = 0.2f * (in[state]
+			+ in[noarr::neighbor<'x'>(state, -1)] + in[noarr::neighbor<'x'>(state, 1)]
+			+ in[noarr::neighbor<'y'>(state, -1)] + in[noarr::neighbor<'y'>(state, 1)]);
+	};
+
+	if (variant == "rows")
+		s.interior(t).for_each(kernel);
+	else if (variant == "zcurve")
+		s.interior(t).order(noarr::merge_zcurve<'y', 'x', 'z'>::maxlen_alignment<zcurve_maxlen, 1>()).for_each(kernel);
+	else if (variant == "tiles")
+		s.tiles(t, tile_x, tile_y).for_each(kernel);
+#ifdef NOARR_BENCHMARKS_TBB
+	else if (variant == "tbb")
+		noarr::tbb_for_each_tile(s.tiles(t, tile_x, tile_y), kernel);
+#endif
+
+	s.for_each_boundary(t, [&](auto state) { out[state] = in[state]; });
+}
+
+template<class In, class Out>
+void step_3d(const std::string &variant, const In &in, const Out &out)
+{
+	auto t = noarr::traverser(in, out);
+	auto s = noarr::stencil<'x', 'y', 'z'>(1, 1, 1);
+
+	auto kernel = [&](auto state)
+	{
+		out[state] = (1.0f / 7) * (in[state]
+			+ in[noarr::neighbor<'x'>(state, -1)] + in[noarr::neighbor<'x'>(state, 1)]
+			+ in[noarr::neighbor<'y'>(state, -1)] + in[noarr::neighbor<'y'>(state, 1)]
+			+ in[noarr::neighbor<'z'>(state, -1)] + in[noarr::neighbor<'z'>(state, 1)]);
+	};
+
+	if (variant == "rows")
+		s.interior(t).for_each(kernel);
+	else if (variant == "zcurve")
+		s.interior(t).order(noarr::merge_zcurve<'z', 'y', 'x', 'c'>::maxlen_alignment<zcurve_maxlen, 1>()).for_each(kernel);
+	else if (variant == "tiles")
+		s.tiles(t, tile_x, tile_y, tile_z).for_each(kernel);
+#ifdef NOARR_BENCHMARKS_TBB
+	else if (variant == "tbb")
+		noarr::tbb_for_each_tile(s.tiles(t, tile_x, tile_y, tile_z), kernel);
+#endif
+
+	s.for_each_boundary(t, [&](auto state) { out[state] = in[state]; });
+}
+
+template<class Structure, class Step>
+void run(const std::string &name, Structure structure, std::size_t steps, Step step)
+{
+	auto a = noarr::make_bag(structure);
+	auto b = noarr::make_bag(structure);
+
+	noarr::traverser(a).for_each([&](auto state)
+	{
+		std::size_t x = noarr::get_index<'x'>(state);
+		std::size_t y = noarr::get_index<'y'>(state);
+		a[state] = (float)((x * 7 + y * 13) % 17);
+	});
+
+	measure(name, 3, [&]
+	{
+		for (std::size_t i = 0; i < steps; i += 2)
+		{
+			step(a, b);
+			step(b, a);
+		}
+	});
+
+	double checksum = 0;
+	noarr::traverser(a).for_each([&](auto state) { checksum += a[state]; });
+	std::cout << "checksum: " << checksum << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 5)
+	{
+		std::cerr << usage << std::endl;
+		return 1;
+	}
+
+	std::string dims = argv[1];
+	std::string variant = argv[2];
+	std::size_t size = parse_size(argv[3], usage);
+	std::size_t steps = parse_size(argv[4], usage);
+
+	if (variant != "rows" && variant != "zcurve" && variant != "tiles" && variant != "tbb")
+	{
+		std::cerr << usage << std::endl;
+		return 1;
+	}
+#ifndef NOARR_BENCHMARKS_TBB
+	if (variant == "tbb")
+	{
+		std::cerr << "jacobi was built without TBB" << std::endl;
+		return 1;
+	}
+#endif
+
+	if (dims == "2d")
+	{
+		auto structure = noarr::scalar<float>() ^ noarr::sized_vectors<'x', 'y'>(size, size);
+		run("jacobi 2d " + variant, structure, steps, [&](const auto &in, const auto &out) { step_2d(variant, in, out); });
+	}
+	else if (dims == "3d")
+	{
+		auto structure = noarr::scalar<float>() ^ noarr::sized_vectors<'x', 'y', 'z'>(size, size, size);
+		run("jacobi 3d " + variant, structure, steps, [&](const auto &in, const auto &out) { step_3d(variant, in, out); });
+	}
+	else
+	{
+		std::cerr << usage << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "noarr/structures_extended.hpp"
+#include "noarr/structures/extra/traverser.hpp"
+#include "noarr/structures/interop/bag.hpp"
+#include "noarr/structures/interop/serialize_data.hpp"
+
+#include "benchmark.hpp"
+
+// Text serialization: the stream operators (serialize_data, deserialize_data) versus the to_chars/from_chars fast path
+
+static const char usage[] =
+	"Usage: serialize <stream|fast> <int|double> <rows> [threads]\n"
+	"  stream: serialize_data and deserialize_data (operator<< and operator>>)\n"
+	"  fast:   serialize_data_fast and deserialize_data_fast (to_chars and from_chars, the formatting in parallel)";
+
+// the matrix has `rows` rows of this length
+constexpr std::size_t columns = 1024;
+
+template<class T>
+void run(const std::string &variant, std::size_t rows, std::size_t threads)
+{
+	auto matrix = noarr::scalar<T>() ^ noarr::sized_vector<'j'>(columns) ^ noarr::sized_vector<'i'>(rows);
+	auto data = noarr::make_bag(matrix);
+	auto copy = noarr::make_bag(matrix);
+	noarr::traverser(data).for_each([&](auto state)
+	{
+		auto i = noarr::get_index<'i'>(state), j = noarr::get_index<'j'>(state);
+		data[state] = (T)((i * 7919 + j * 104729) % 1000003) / (T)7;
+	});
+
+	std::string text;
+	measure(variant + " serialize", 5, [&]
+	{
+		std::ostringstream out;
+		if (variant == "stream")
+			noarr::serialize_data(out, data);
+		else
+			noarr::serialize_data_fast(out, data, threads);
+		text = std::move(out).str();
+	});
+
+	measure(variant + " deserialize", 5, [&]
+	{
+		std::istringstream in(text);
+		if (variant == "stream")
+			noarr::deserialize_data(in, copy);
+		else
+			noarr::deserialize_data_fast(in, copy);
+	});
+
+	double checksum = 0;
+	noarr::traverser(copy).for_each([&](auto state) { checksum += (double)copy[state]; });
+	std::cout << "text size: " << text.size() << " B" << std::endl;
+	std::cout << "checksum: " << checksum << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 4 && argc != 5)
+	{
+		std::cerr << usage << std::endl;
+		return 1;
+	}
+
+	std::string variant = argv[1];
+	std::string type = argv[2];
+	std::size_t rows = parse_size(argv[3], usage);
+	std::size_t threads = argc == 5 ? parse_size(argv[4], usage) : 0;
+
+	if ((variant != "stream" && variant != "fast") || (type != "int" && type != "double"))
+	{
+		std::cerr << usage << std::endl;
+		return 1;
+	}
+
+	if (type == "int")
+		run<std::int32_t>(variant, rows, threads);
+	else
+		run<double>(variant, rows, threads);
+
+	return 0;
+}
@@ -0,0 +1,169 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "noarr/structures_extended.hpp"
+#include "noarr/structures/extra/traverser.hpp"
+#include "noarr/structures/interop/bag.hpp"
+#include "noarr/structures/structs/csr.hpp"
+
+#include "benchmark.hpp"
+
+// Sparse matrix times dense vector (spmv) or dense matrix (spmm), the sparse matrix is stored either in CSR or as a dense matrix
+
+static const char usage[] =
+	"Usage: spmv <spmv|spmm> <csr|dense> <size> <nonzeros per row> [columns of the dense matrix (spmm only, default 8)]";
+
+// a random square matrix with the given number of nonzeros in each row
+struct sparse_matrix
+{
+	std::size_t n;
+	std::vector<std::size_t> row_ptr;
+	std::vector<std::uint32_t> cols;
+	std::vector<float> values;
+
+	sparse_matrix(std::size_t n, std::size_t nnz_per_row) : n(n)
+	{
+		std::mt19937 rng(42);
+		std::uniform_int_distribution<std::size_t> col_dist(0, n - 1);
+		row_ptr.push_back(0);
+		for (std::size_t i = 0; i < n; i++)
+		{
+			for (std::size_t k = 0; k < nnz_per_row; k++)
+			{
+				cols.push_back((std::uint32_t)col_dist(rng));
+				values.push_back((float)(k % 5 + 1));
+			}
+			row_ptr.push_back(cols.size());
+		}
+	}
+};
+
+template<class Values, class Cols, class X, class Y>
+void spmv_csr(const Values &values, const Cols &cols, const X &x, const Y &y)
+{
+	noarr::traverser(y).for_each([&](auto state) { y[state] = 0; });
+	noarr::traverser(values, cols, y).for_each([&](auto state)
+	{
+		y[state] += values[state] * x[noarr::idx<'c'>((std::size_t)cols[state])];
+	});
+}
+
+template<class A, class X, class Y>
+void spmv_dense(const A &a, const X &x, const Y &y)
+{
+	noarr::traverser(y).for_each([&](auto state) { y[state] = 0; });
+	noarr::traverser(a, x, y).for_each([&](auto state)
+	{
+		y[state] += a[state] * x[state];
+	});
+}
+
+template<class Values, class Cols, class X, class Y>
+void spmm_csr(const Values &values, const Cols &cols, const X &x, const Y &y)
+{
+	noarr::traverser(y).for_each([&](auto state) { y[state] = 0; });
+	noarr::traverser(values, cols, y).template for_dims<'i', 'j'>([&](auto inner)
+	{
+		auto nz_state = inner.state();
+		float value = values[nz_state];
+		std::size_t col = cols[nz_state];
+		inner.for_each([&](auto state)
+		{
+			y[state] += value * x[noarr::idx<'k', 'c'>(noarr::get_index<'k'>(state), col)];
+		});
+	});
+}
+
+template<class A, class X, class Y>
+void spmm_dense(const A &a, const X &x, const Y &y)
+{
+	noarr::traverser(y).for_each([&](auto state) { y[state] = 0; });
+	noarr::traverser(a, x, y).template for_dims<'i', 'j'>([&](auto inner)
+	{
+		float value = a[inner.state()];
+		inner.for_each([&](auto state)
+		{
+			y[state] += value * x[state];
+		});
+	});
+}
+
+template<class Y>
+void print_checksum(const Y &y)
+{
+	double checksum = 0;
+	noarr::traverser(y).for_each([&](auto state) { checksum += y[state]; });
+	std::cout << "checksum: " << checksum << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 5 && argc != 6)
+	{
+		std::cerr << usage << std::endl;
+		return 1;
+	}
+
+	std::string op = argv[1];
+	std::string format = argv[2];
+	std::size_t n = parse_size(argv[3], usage);
+	std::size_t nnz_per_row = parse_size(argv[4], usage);
+	std::size_t k = argc == 6 ? parse_size(argv[5], usage) : 8;
+
+	if ((op != "spmv" && op != "spmm") || (format != "csr" && format != "dense") || (op == "spmv" && argc == 6))
+	{
+		std::cerr << usage << std::endl;
+		return 1;
+	}
+
+	sparse_matrix m(n, nnz_per_row);
+	std::string name = op + " " + format;
+
+	auto csr = noarr::csr<'i', 'j'>(m.row_ptr.data(), n);
+	auto values = noarr::make_bag(noarr::scalar<float>() ^ csr, m.values.data());
+	auto cols = noarr::make_bag(noarr::scalar<std::uint32_t>() ^ csr, m.cols.data());
+
+	// the dense matrix has the sum of the duplicate nonzeros (it is only allocated if needed)
+	std::size_t dense_n = format == "dense" ? n : 0;
+	auto dense = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vectors<'j', 'i'>(dense_n, dense_n));
+	if (format == "dense")
+	{
+		noarr::traverser(values, cols).for_each([&](auto state)
+		{
+			dense.template at<'i', 'j'>(noarr::get_index<'i'>(state), (std::size_t)cols[state]) += values[state];
+		});
+	}
+
+	if (op == "spmv")
+	{
+		auto x = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vector<'j'>(n));
+		auto y = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vector<'i'>(n));
+		noarr::traverser(x).for_each([&](auto state) { x[state] = (float)(noarr::get_index<'j'>(state) % 7); });
+
+		if (format == "csr")
+			measure(name, 10, [&] { spmv_csr(values, cols, x.get_ref() ^ noarr::rename<'j', 'c'>(), y); });
+		else
+			measure(name, 10, [&] { spmv_dense(dense, x, y); });
+
+		print_checksum(y);
+	}
+	else
+	{
+		auto x = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vectors<'k', 'j'>(k, n));
+		auto y = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vectors<'k', 'i'>(k, n));
+		noarr::traverser(x).for_each([&](auto state) { x[state] = (float)((noarr::get_index<'j'>(state) + noarr::get_index<'k'>(state)) % 7); });
+
+		if (format == "csr")
+			measure(name, 10, [&] { spmm_csr(values, cols, x.get_ref() ^ noarr::rename<'j', 'c'>(), y); });
+		else
+			measure(name, 10, [&] { spmm_dense(dense, x, y); });
+
+		print_checksum(y);
+	}
+
+	return 0;
+}
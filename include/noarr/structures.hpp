@@ -4,6 +4,7 @@
  */
 
 #include "structures/base/contain.hpp"
+#include "structures/base/fast_length.hpp"
 #include "structures/base/signature.hpp"
 #include "structures/base/state.hpp"
 #include "structures/base/structs_common.hpp"
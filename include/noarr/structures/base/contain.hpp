@@ -19,40 +19,9 @@ namespace helpers {
 template<class, class... TS>
 struct contain_impl;
 
-/**
- * @brief structure that facilitates `.get` method of the `contain` structure
- * 
- * @tparam T: the `contain` structure
- * @tparam I: the index of the desired field
- */
-template<class T, std::size_t I>
-struct contain_get {
-	static constexpr decltype(auto) get(const T &t) noexcept {
-		return t.template _get_next<I>();
-	}
-
-	static constexpr decltype(auto) get(T &t) noexcept {
-		return t.template _get_next<I>();
-	}
-};
-
-template<class T>
-struct contain_get<T, 0> {
-	static constexpr decltype(auto) get(const T &t) noexcept {
-		return t._get();
-	}
-
-	static constexpr decltype(auto) get(T &t) noexcept {
-		return t._get();
-	}
-};
-
 // an implementation for the pair (T, TS...) where neither is empty
 template<class T, class... TS>
 struct contain_impl<std::enable_if_t<!std::is_empty<T>::value && !std::is_empty<contain_impl<void, TS...>>::value && (sizeof...(TS) > 0)>, T, TS...> {
-	template<class, std::size_t>
-	friend struct contain_get;
-
 	T t_;
 	contain_impl<void, TS...> ts_;
 
@@ -61,24 +30,21 @@ struct contain_impl<std::enable_if_t<!std::is_empty<T>::value && !std::is_empty<
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() const noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		if constexpr(I == 0)
+			return _get();
+		else
+			return ts_.template get<I - 1>();
 	}
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		if constexpr(I == 0)
+			return _get();
+		else
+			return ts_.template get<I - 1>();
 	}
 
 private:
-	template<std::size_t I>
-	constexpr decltype(auto) _get_next() const noexcept {
-		return ts_.template get<I - 1>();
-	}
-
-	template<std::size_t I>
-	constexpr decltype(auto) _get_next() noexcept {
-		return ts_.template get<I - 1>();
-	}
 
 	constexpr const auto &_get() const noexcept {
 		return t_;
@@ -92,9 +58,6 @@ private:
 // an implementation for the pair (T, TS...) where TS... is empty
 template<class T, class... TS>
 struct contain_impl<std::enable_if_t<!std::is_empty<T>::value && std::is_empty<contain_impl<void, TS...>>::value && (sizeof...(TS) > 0)>, T, TS...> : private contain_impl<void, TS...> {
-	template<class, std::size_t>
-	friend struct contain_get;
-
 	T t_;
 
 	constexpr contain_impl() noexcept = default;
@@ -103,24 +66,21 @@ struct contain_impl<std::enable_if_t<!std::is_empty<T>::value && std::is_empty<c
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() const noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		if constexpr(I == 0)
+			return _get();
+		else
+			return contain_impl<void, TS...>::template get<I - 1>();
 	}
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		if constexpr(I == 0)
+			return _get();
+		else
+			return contain_impl<void, TS...>::template get<I - 1>();
 	}
 
 private:
-	template<std::size_t I>
-	constexpr decltype(auto) _get_next() const noexcept {
-		return contain_impl<void, TS...>::template get<I - 1>();
-	}
-
-	template<std::size_t I>
-	constexpr decltype(auto) _get_next() noexcept {
-		return contain_impl<void, TS...>::template get<I - 1>();
-	}
 
 	constexpr const auto &_get() const noexcept {
 		return t_;
@@ -134,33 +94,27 @@ private:
 // an implementation for the pair (T, TS...) where T is empty
 template<class T, class... TS>
 struct contain_impl<std::enable_if_t<std::is_empty<T>::value && (sizeof...(TS) > 0)>, T, TS...> : private contain_impl<void, TS...> {
-	template<class, std::size_t>
-	friend struct contain_get;
-
 	constexpr contain_impl() noexcept = default;
 	explicit constexpr contain_impl(TS... ts) noexcept : contain_impl<void, TS...>(ts...) {}
 	explicit constexpr contain_impl(T, TS... ts) noexcept : contain_impl<void, TS...>(ts...) {}
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() const noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		if constexpr(I == 0)
+			return _get();
+		else
+			return contain_impl<void, TS...>::template get<I - 1>();
 	}
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		if constexpr(I == 0)
+			return _get();
+		else
+			return contain_impl<void, TS...>::template get<I - 1>();
 	}
 
 private:
-	template<std::size_t I>
-	constexpr decltype(auto) _get_next() const noexcept {
-		return contain_impl<void, TS...>::template get<I - 1>();
-	}
-
-	template<std::size_t I>
-	constexpr decltype(auto) _get_next() noexcept {
-		return contain_impl<void, TS...>::template get<I - 1>();
-	}
 
 	static constexpr auto _get() noexcept {
 		return T();
@@ -170,20 +124,19 @@ private:
 // an implementation for an empty T
 template<class T>
 struct contain_impl<std::enable_if_t<std::is_empty<T>::value>, T> {
-	template<class, std::size_t>
-	friend struct contain_get;
-
 	constexpr contain_impl() noexcept = default;
 	explicit constexpr contain_impl(T) noexcept {}
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() const noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		static_assert(I == 0, "Index out of range");
+		return _get();
 	}
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		static_assert(I == 0, "Index out of range");
+		return _get();
 	}
 
 private:
@@ -195,9 +148,6 @@ private:
 // an implementation for an nonempty T
 template<class T>
 struct contain_impl<std::enable_if_t<!std::is_empty<T>::value>, T> {
-	template<class, std::size_t>
-	friend struct contain_get;
-
 	T t_;
 
 	constexpr contain_impl() noexcept = delete;
@@ -205,12 +155,14 @@ struct contain_impl<std::enable_if_t<!std::is_empty<T>::value>, T> {
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() const noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		static_assert(I == 0, "Index out of range");
+		return _get();
 	}
 
 	template<std::size_t I>
 	constexpr decltype(auto) get() noexcept {
-		return contain_get<contain_impl, I>::get(*this);
+		static_assert(I == 0, "Index out of range");
+		return _get();
 	}
 
 private:
@@ -0,0 +1,134 @@
+#ifndef NOARR_STRUCTURES_FAST_LENGTH_HPP
+#define NOARR_STRUCTURES_FAST_LENGTH_HPP
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace noarr {
+
+namespace helpers {
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 fast_length_uint128;
+#endif
+
+// an unsigned type twice as wide as std::size_t (void if there is none)
+template<std::size_t SizeBits = sizeof(std::size_t) * CHAR_BIT>
+struct fast_length_wide { using type = void; };
+
+template<>
+struct fast_length_wide<32> { using type = std::uint64_t; };
+
+#if defined(__SIZEOF_INT128__)
+template<>
+struct fast_length_wide<64> { using type = fast_length_uint128; };
+#endif
+
+using fast_length_wide_t = typename fast_length_wide<>::type;
+
+} // namespace helpers
+
+/**
+ * @brief a dynamic length (or a block size, stride, etc.) that precomputes a reciprocal, so dividing by it (and taking the remainder) needs no division instruction
+ *
+ * It can be used wherever a dynamic `std::size_t` length is accepted (e.g. `set_length<'i'>(fast_length(n))`, `into_blocks<'i', 'I', 'i'>(fast_length(n))`).
+ * Division by a power of two becomes a shift (and the remainder a mask), division by other values becomes a multiplication and a shift.
+ * The structures that divide by a length (e.g. `merge_blocks` by the minor length) then use the fast division automatically.
+ */
+class fast_length {
+	enum class method : unsigned char { divide, shift, multiply, multiply_add };
+
+	std::size_t value_;
+	std::size_t magic_;
+	unsigned char shift_;
+	method method_;
+
+	static constexpr unsigned floor_log2(std::size_t value) noexcept {
+		unsigned log = 0;
+		while(value >>= 1)
+			log++;
+		return log;
+	}
+
+	// the quotient and the remainder of 2^(bits + log) / value (the quotient fits in std::size_t since value > 2^log)
+	template<class Wide>
+	static constexpr void reciprocal(std::size_t value, unsigned log, std::size_t &quo, std::size_t &rem) noexcept {
+		constexpr unsigned bits = sizeof(std::size_t) * CHAR_BIT;
+		const Wide num = Wide(1) << (bits + log);
+		quo = std::size_t(num / value);
+		rem = std::size_t(num % value);
+	}
+
+	template<class Wide>
+	static constexpr std::size_t mul_high(std::size_t a, std::size_t b) noexcept {
+		constexpr unsigned bits = sizeof(std::size_t) * CHAR_BIT;
+		return std::size_t((Wide(a) * b) >> bits);
+	}
+
+public:
+	constexpr fast_length(std::size_t value) noexcept : value_(value), magic_(0), shift_(0), method_(method::divide) {
+		if(value == 0)
+			return;
+		const unsigned log = floor_log2(value);
+		if((value & (value - 1)) == 0) {
+			shift_ = (unsigned char)log;
+			method_ = method::shift;
+			return;
+		}
+		if constexpr(!std::is_void_v<helpers::fast_length_wide_t>) {
+			// the round-up method (as in libdivide), the magic number has one more bit than std::size_t when the error is too large
+			std::size_t quo = 0, rem = 0;
+			reciprocal<helpers::fast_length_wide_t>(value, log, quo, rem);
+			shift_ = (unsigned char)log;
+			if(value - rem < (std::size_t(1) << log)) {
+				method_ = method::multiply;
+			} else {
+				quo += quo;
+				const std::size_t twice_rem = rem + rem;
+				if(twice_rem >= value || twice_rem < rem)
+					quo++;
+				method_ = method::multiply_add;
+			}
+			magic_ = quo + 1;
+		}
+	}
+
+	constexpr operator std::size_t() const noexcept { return value_; }
+
+	constexpr std::size_t value() const noexcept { return value_; }
+
+	constexpr std::size_t divide(std::size_t n) const noexcept {
+		switch(method_) {
+		case method::shift:
+			return n >> shift_;
+		case method::multiply:
+			if constexpr(!std::is_void_v<helpers::fast_length_wide_t>)
+				return mul_high<helpers::fast_length_wide_t>(magic_, n) >> shift_;
+			break;
+		case method::multiply_add:
+			if constexpr(!std::is_void_v<helpers::fast_length_wide_t>) {
+				const std::size_t q = mul_high<helpers::fast_length_wide_t>(magic_, n);
+				return (((n - q) >> 1) + q) >> shift_;
+			}
+			break;
+		case method::divide:
+			break;
+		}
+		return n / value_;
+	}
+
+	constexpr std::size_t modulo(std::size_t n) const noexcept {
+		if(method_ == method::shift)
+			return n & (value_ - 1);
+		return n - divide(n) * value_;
+	}
+
+	friend constexpr std::size_t operator/(std::size_t n, fast_length d) noexcept { return d.divide(n); }
+	friend constexpr std::size_t operator%(std::size_t n, fast_length d) noexcept { return d.modulo(n); }
+};
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_FAST_LENGTH_HPP
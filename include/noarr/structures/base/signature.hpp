@@ -2,6 +2,7 @@
 #define NOARR_STRUCTURES_SIGNATURE_HPP
 
 #include "contain.hpp"
+#include "fast_length.hpp"
 
 namespace noarr {
 
@@ -29,6 +30,8 @@ template<class T>
 struct arg_length_from;
 template<>
 struct arg_length_from<std::size_t> { using type = dynamic_arg_length; };
+template<>
+struct arg_length_from<fast_length> { using type = dynamic_arg_length; };
 template<std::size_t L>
 struct arg_length_from<std::integral_constant<std::size_t, L>> { using type = static_arg_length<L>; };
 
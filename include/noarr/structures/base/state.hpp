@@ -2,6 +2,7 @@
 #define NOARR_STRUCTURES_STATE_HPP
 
 #include "contain.hpp"
+#include "fast_length.hpp"
 #include "utility.hpp"
 
 namespace noarr {
@@ -25,61 +26,111 @@ namespace helpers {
 		using prepend = state_items_pack<HeadStateItem, StateItems...>;
 	};
 
-	template<class Tag, class... StateItems>
-	struct state_index_of;
+	// only used in `decltype` to concatenate packs using a fold expression (instead of a recursive template)
+	template<class... StateItemsA, class... StateItemsB>
+	constexpr state_items_pack<StateItemsA..., StateItemsB...> operator+(state_items_pack<StateItemsA...>, state_items_pack<StateItemsB...>) noexcept;
 
-	template<class Tag, class ValueType, class... TailStateItems>
-	struct state_index_of<Tag, state_item<Tag, ValueType>, TailStateItems...> {
-		static constexpr auto result = some<std::size_t>{0};
-	};
+	// the pack of those `StateItems` for which `Keep` is true
+	template<template<class StateItem> class Keep, class... StateItems>
+	using state_items_filter = decltype((state_items_pack<>() + ... + std::conditional_t<Keep<StateItems>::value, state_items_pack<StateItems>, state_items_pack<>>()));
 
-	template<class Tag, class HeadStateItem, class... TailStateItems>
-	struct state_index_of<Tag, HeadStateItem, TailStateItems...> {
-		static constexpr auto result = state_index_of<Tag, TailStateItems...>::result.and_then([](auto v){return v+1;});
-	};
+	template<std::size_t Index, bool Present>
+	struct state_index_result { static constexpr auto result = some<std::size_t>{Index}; };
 
-	template<class Tag>
-	struct state_index_of<Tag> {
-		static constexpr auto result = none{};
-	};
+	template<std::size_t Index>
+	struct state_index_result<Index, false> { static constexpr auto result = none{}; };
 
 	template<class Tag, class... StateItems>
-	struct state_remove_item;
-
-	template<class Tag, class ValueType, class... TailStateItems>
-	struct state_remove_item<Tag, state_item<Tag, ValueType>, TailStateItems...> {
-		using result = typename state_remove_item<Tag, TailStateItems...>::result;
+	struct state_index_of {
+		static constexpr bool matches[] = {std::is_same_v<typename StateItems::tag, Tag>..., false};
+		static constexpr std::size_t index = find_first(matches);
+		static constexpr auto result = state_index_result<index, (index < sizeof...(StateItems))>::result;
 	};
 
-	template<class Tag, class HeadStateItem, class... TailStateItems>
-	struct state_remove_item<Tag, HeadStateItem, TailStateItems...> {
-		using result = typename state_remove_item<Tag, TailStateItems...>::result::template prepend<HeadStateItem>;
-	};
+	template<class StateItemsPack, class... Tags>
+	struct state_remove_items;
 
-	template<class Tag>
-	struct state_remove_item<Tag> {
-		using result = state_items_pack<>;
+	template<class... StateItems, class... Tags>
+	struct state_remove_items<state_items_pack<StateItems...>, Tags...> {
+		template<class StateItem>
+		using keep = std::bool_constant<!(std::is_same_v<typename StateItem::tag, Tags> || ...)>;
+		using result = state_items_filter<keep, StateItems...>;
 	};
 
-	template<class StateItemsPack, class... Tags>
-	struct state_remove_items;
+	// the dynamic `std::size_t` values of a state are stored in a flat array (the other values, e.g. the static ones, are stored in a `contain`)
+	template<class ValueType>
+	static constexpr bool state_in_slot = std::is_same_v<ValueType, std::size_t>;
+
+	template<std::size_t N, class ValueType>
+	constexpr void state_store_slot(std::size_t (&slots)[N], std::size_t &i, ValueType value) noexcept {
+		if constexpr(state_in_slot<ValueType>)
+			slots[i++] = value;
+	}
+
+	template<std::size_t N>
+	struct state_slots {
+		std::size_t slots[N];
+
+		constexpr state_slots() noexcept = delete;
 
-	template<class StateItemsPack>
-	struct state_remove_items<StateItemsPack> {
-		using result = StateItemsPack;
+		// takes the values of all the items, keeps those stored in slots
+		template<class... ValueTypes>
+		explicit constexpr state_slots(ValueTypes... values) noexcept : slots() {
+			std::size_t i = 0;
+			(..., state_store_slot(slots, i, values));
+		}
 	};
 
-	template<class... StateItems, class Tag, class... Tags>
-	struct state_remove_items<state_items_pack<StateItems...>, Tag, Tags...> {
-		using recursion_result = typename state_remove_item<Tag, StateItems...>::result;
-		using result = typename state_remove_items<recursion_result, Tags...>::result;
+	template<>
+	struct state_slots<0> {
+		constexpr state_slots() noexcept = default;
+
+		template<class... ValueTypes>
+		explicit constexpr state_slots(ValueTypes...) noexcept {}
 	};
+
+	// the placeholder in the `contain` of a state for a value stored in a slot
+	struct state_slot_placeholder {};
+
+	template<class ValueType>
+	using state_contained_t = std::conditional_t<state_in_slot<ValueType>, state_slot_placeholder, ValueType>;
+
+	template<class ValueType>
+	constexpr state_contained_t<ValueType> state_contained(ValueType value) noexcept {
+		if constexpr(state_in_slot<ValueType>)
+			return state_slot_placeholder();
+		else
+			return value;
+	}
+
+	// the slot of the item at `Index` (the number of the slots before it)
+	template<std::size_t Index, bool... InSlot>
+	constexpr std::size_t state_slot_of() noexcept {
+		constexpr bool in_slot[] = {InSlot..., false};
+		std::size_t slot = 0;
+		for(std::size_t i = 0; i < Index; i++)
+			slot += in_slot[i];
+		return slot;
+	}
 } // namespace helpers
 
+/**
+ * @brief a set of items (e.g. the indices and the lengths in dimensions), each identified by its tag, with its value type in the type of the state
+ *
+ * The dynamic indices (`std::size_t`) are stored in a flat array, the slot of each item is determined at compile time,
+ * so `get` and `get_ref` are a single array access and `with` and `remove` copy the array without any recursive instantiations.
+ * The static indices (`std::integral_constant`) are only in the type.
+ */
 template<class... StateItems>
-struct state : contain<typename StateItems::value_type...> {
-	using base = contain<typename StateItems::value_type...>;
-	using base::base;
+struct state : contain<helpers::state_slots<(0 + ... + helpers::state_in_slot<typename StateItems::value_type>)>, helpers::state_contained_t<typename StateItems::value_type>...> {
+	static constexpr std::size_t num_slots = (0 + ... + helpers::state_in_slot<typename StateItems::value_type>);
+	using base = contain<helpers::state_slots<num_slots>, helpers::state_contained_t<typename StateItems::value_type>...>;
+
+	constexpr state() noexcept = default;
+
+	template<class... Values, class = std::enable_if_t<sizeof...(Values) == sizeof...(StateItems) && (sizeof...(Values) > 0)>>
+	explicit constexpr state(Values... values) noexcept
+		: base(helpers::state_slots<num_slots>(typename StateItems::value_type(values)...), helpers::state_contained(typename StateItems::value_type(values))...) {}
 
 	template<class Tag>
 	static constexpr auto index_of = helpers::state_index_of<Tag, StateItems...>::result;
@@ -89,16 +140,32 @@ struct state : contain<typename StateItems::value_type...> {
 
 	static constexpr bool is_empty = !sizeof...(StateItems);
 
+private:
+	static constexpr bool item_in_slot[] = {helpers::state_in_slot<typename StateItems::value_type>..., false};
+
+	template<class Tag>
+	static constexpr bool in_slot = item_in_slot[index_of<Tag>.value];
+
+	template<class Tag>
+	static constexpr std::size_t slot_of = helpers::state_slot_of<index_of<Tag>.value, helpers::state_in_slot<typename StateItems::value_type>...>();
+
+public:
 	template<class Tag>
 	constexpr auto get() const noexcept {
 		static_assert(contains<Tag>, "No such item");
-		return base::template get<index_of<Tag>.value>();
+		if constexpr(in_slot<Tag>)
+			return base::template get<0>().slots[slot_of<Tag>];
+		else
+			return base::template get<index_of<Tag>.value + 1>();
 	}
 
 	template<class Tag>
 	constexpr auto &get_ref() noexcept {
 		static_assert(contains<Tag>, "No such item");
-		return base::template get<index_of<Tag>.value>();
+		if constexpr(in_slot<Tag>)
+			return base::template get<0>().slots[slot_of<Tag>];
+		else
+			return base::template get<index_of<Tag>.value + 1>();
 	}
 
 	template<class... KeptStateItems>
@@ -134,6 +201,8 @@ namespace helpers {
 
 constexpr std::size_t supported_index_type(std::size_t);
 
+constexpr fast_length supported_index_type(fast_length);
+
 template<std::size_t Value>
 constexpr std::integral_constant<std::size_t, Value> supported_index_type(std::integral_constant<std::size_t, Value>);
 
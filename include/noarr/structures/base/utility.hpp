@@ -9,66 +9,73 @@ namespace noarr {
 
 namespace helpers {
 
+// only used in `decltype` to concatenate packs using a fold expression (instead of a recursive template)
+template<class Pack>
+struct integer_sequence_wrap {
+	using type = Pack;
+};
+
+template<class T, T... vs1, T... vs2>
+constexpr integer_sequence_wrap<std::integer_sequence<T, vs1..., vs2...>> operator+(integer_sequence_wrap<std::integer_sequence<T, vs1...>>, integer_sequence_wrap<std::integer_sequence<T, vs2...>>) noexcept;
+
 template<class... Packs>
-struct integer_sequence_concat_impl;
+struct integer_sequence_concat_impl {
+	using type = typename decltype((... + integer_sequence_wrap<Packs>()))::type;
+};
+
+template<class Sep, class Pack>
+struct integer_sequence_prepend_sep;
 
-template<class T, T... vs1, T... vs2, class...Packs>
-struct integer_sequence_concat_impl<std::integer_sequence<T, vs1...>, std::integer_sequence<T, vs2...>, Packs...> {
-	using type = typename integer_sequence_concat_impl<std::integer_sequence<T, vs1..., vs2...>, Packs...>::type;
+template<class T, T... sep, T... vs>
+struct integer_sequence_prepend_sep<std::integer_sequence<T, sep...>, std::integer_sequence<T, vs...>> {
+	using type = std::integer_sequence<T, sep..., vs...>;
 };
 
-template<class T, T... vs1>
-struct integer_sequence_concat_impl<std::integer_sequence<T, vs1...>> {
-	using type = std::integer_sequence<T, vs1...>;
+// empty packs are skipped (no separator is added for them)
+template<class T, T... sep>
+struct integer_sequence_prepend_sep<std::integer_sequence<T, sep...>, std::integer_sequence<T>> {
+	using type = std::integer_sequence<T>;
 };
 
 template<class Sep, class... Packs>
 struct integer_sequence_concat_sep_impl;
 
-template<class T, T... vs1, T... vs2, T... sep, class...Packs>
-struct integer_sequence_concat_sep_impl<std::integer_sequence<T, sep...>, std::integer_sequence<T, vs1...>, std::integer_sequence<T, vs2...>, Packs...> {
-	using type = typename integer_sequence_concat_sep_impl<std::integer_sequence<T, sep...>, std::integer_sequence<T, vs1..., vs2...>, Packs...>::type;
-};
+// leading empty packs are skipped
+template<class T, T... sep, class... Packs>
+struct integer_sequence_concat_sep_impl<std::integer_sequence<T, sep...>, std::integer_sequence<T>, Packs...> : integer_sequence_concat_sep_impl<std::integer_sequence<T, sep...>, Packs...> {};
 
-template<class T, T v1, T v2, T... vs1, T... vs2, T... sep, class...Packs>
-struct integer_sequence_concat_sep_impl<std::integer_sequence<T, sep...>, std::integer_sequence<T, v1, vs1...>, std::integer_sequence<T, v2, vs2...>, Packs...> {
-	using type = typename integer_sequence_concat_sep_impl<std::integer_sequence<T, sep...>, std::integer_sequence<T, v1, vs1..., sep..., v2, vs2...>, Packs...>::type;
+template<class T, T... sep>
+struct integer_sequence_concat_sep_impl<std::integer_sequence<T, sep...>, std::integer_sequence<T>> {
+	using type = std::integer_sequence<T>;
 };
 
-template<class T, T... vs1, T... sep>
-struct integer_sequence_concat_sep_impl<std::integer_sequence<T, sep...>, std::integer_sequence<T, vs1...>> {
-	using type = std::integer_sequence<T, vs1...>;
+template<class T, T... sep, T v1, T... vs1, class... Packs>
+struct integer_sequence_concat_sep_impl<std::integer_sequence<T, sep...>, std::integer_sequence<T, v1, vs1...>, Packs...> {
+	using type = typename decltype((integer_sequence_wrap<std::integer_sequence<T, v1, vs1...>>() + ... + integer_sequence_wrap<typename integer_sequence_prepend_sep<std::integer_sequence<T, sep...>, Packs>::type>()))::type;
 };
 
-template<class T, T V, class Pack, class = void>
+template<class T, T V, class Pack>
 struct integer_sequence_contains_impl;
 
 template<class T, T V, T... VS>
-struct integer_sequence_contains_impl<T, V, std::integer_sequence<T, V, VS...>> : std::true_type {};
-
-template<class T, T V, T v, T... VS>
-struct integer_sequence_contains_impl<T, V, std::integer_sequence<T, v, VS...>, std::enable_if_t<(V != v)>> : integer_sequence_contains_impl<T, V, std::integer_sequence<T, VS...>> {};
+struct integer_sequence_contains_impl<T, V, std::integer_sequence<T, VS...>> : std::bool_constant<((V == VS) || ...)> {};
 
-template<class T, T V>
-struct integer_sequence_contains_impl<T, V, std::integer_sequence<T>> : std::false_type {};
-
-template<class In, class Set, class = void>
+template<class In, class Set>
 struct integer_sequence_restrict_impl;
 
-template<class T, T v, T ...vs, class Set>
-struct integer_sequence_restrict_impl<std::integer_sequence<T, v, vs...>, Set, std::enable_if_t<integer_sequence_contains_impl<T, v, Set>::value>> {
-	using type = typename integer_sequence_concat_impl<std::integer_sequence<T, v>, typename integer_sequence_restrict_impl<std::integer_sequence<T, vs...>, Set>::type>::type;
-};
-
-template<class T, T v, T ...vs, class Set>
-struct integer_sequence_restrict_impl<std::integer_sequence<T, v, vs...>, Set, std::enable_if_t<!integer_sequence_contains_impl<T, v, Set>::value>> {
-	using type = typename integer_sequence_restrict_impl<std::integer_sequence<T, vs...>, Set>::type;
+template<class T, T... vs, class Set>
+struct integer_sequence_restrict_impl<std::integer_sequence<T, vs...>, Set> {
+	using type = typename decltype((integer_sequence_wrap<std::integer_sequence<T>>() + ... + integer_sequence_wrap<std::conditional_t<integer_sequence_contains_impl<T, vs, Set>::value, std::integer_sequence<T, vs>, std::integer_sequence<T>>>()))::type;
 };
 
-template<class T, class Set>
-struct integer_sequence_restrict_impl<std::integer_sequence<T>, Set> {
-	using type = std::integer_sequence<T>;
-};
+// the index of the first `true` in `matches`, the last item is a sentinel (returned if there is no other `true`)
+template<std::size_t N>
+constexpr std::size_t find_first(const bool (&matches)[N]) noexcept {
+	for(std::size_t i = 0; i < N - 1; i++)
+		if(matches[i])
+			return i;
+	return N - 1;
+}
 
 template<class T, T v, class ...Branches>
 struct integer_tree {
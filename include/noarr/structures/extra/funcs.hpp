@@ -61,17 +61,31 @@ constexpr auto sub_ptr(volatile void *ptr, std::size_t off) noexcept { return (v
 template<class T>
 constexpr auto sub_ptr(const volatile void *ptr, std::size_t off) noexcept { return (const volatile T*) ((const volatile char*) ptr + off); }
 
+template<class Bits, class CvVoid, class Offset>
+constexpr auto bits_at(CvVoid *ptr, Offset off) noexcept {
+	using byte = std::remove_pointer_t<decltype(sub_ptr<unsigned char>(ptr, 0))>;
+	if constexpr(std::is_same_v<Offset, bit_offset>)
+		return bits_ref<Bits::width, byte>(sub_ptr<unsigned char>(ptr, off.bytes), off.bit);
+	else
+		return bits_ref<Bits::width, byte>(sub_ptr<unsigned char>(ptr, off), 0);
+}
+
 } // namespace helpers
 
 /**
  * @brief returns the item in the blob specified by `ptr` offset of which is specified by a structure
  * 
+ * For a sub-byte scalar (`scalar_bits`), a `bits_ref` proxy is returned instead of a reference.
+ *
  * @param ptr: the pointer to blob structure
  */
 template<class State, class CvVoid>
 constexpr auto get_at(CvVoid *ptr, State state) noexcept { return [ptr, state](auto structure) constexpr noexcept -> decltype(auto) {
 	using type = scalar_t<decltype(structure), State>;
-	return *helpers::sub_ptr<type>(ptr, offset_of<scalar<type>>(structure, state));
+	if constexpr(helpers::is_bits<type>)
+		return helpers::bits_at<type>(ptr, offset_of<scalar<type>>(structure, state));
+	else
+		return *helpers::sub_ptr<type>(ptr, offset_of<scalar<type>>(structure, state));
 }; }
 
 /**
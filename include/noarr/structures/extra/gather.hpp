@@ -0,0 +1,134 @@
+#ifndef NOARR_STRUCTURES_GATHER_HPP
+#define NOARR_STRUCTURES_GATHER_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../extra/reduce.hpp"
+#include "../extra/to_struct.hpp"
+#include "../extra/traverser.hpp"
+
+namespace noarr {
+
+namespace helpers {
+
+// the innermost dimension of a signature, if it is not a tuple dimension
+template<class Signature>
+struct gather_innermost_dim {
+	static constexpr bool found = false;
+	static constexpr char dim = '\0';
+};
+template<char Dim, class ArgLength, class ValueType>
+struct gather_innermost_dim<function_sig<Dim, ArgLength, scalar_sig<ValueType>>> {
+	static constexpr bool found = true;
+	static constexpr char dim = Dim;
+};
+template<char Dim, class ArgLength, class RetSig>
+struct gather_innermost_dim<function_sig<Dim, ArgLength, RetSig>> : gather_innermost_dim<RetSig> {};
+
+inline void gather_prefetch(const void *ptr) noexcept {
+#if defined(__GNUC__)
+	__builtin_prefetch(ptr);
+#else
+	(void)ptr;
+#endif
+}
+
+// how many steps ahead (in the innermost dimension) are the indirectly accessed elements prefetched
+constexpr std::size_t gather_prefetch_distance = 32;
+
+template<char Dim, class IdxBag, class DataBag>
+struct gather_impl {
+	using idx_struct = typename to_struct<IdxBag>::type;
+	using data_struct = typename to_struct<DataBag>::type;
+	using top_struct = decltype(traverser(std::declval<IdxBag>(), std::declval<DataBag>()).top_struct());
+	using inner = gather_innermost_dim<typename top_struct::signature>;
+
+	// the prefetching only makes sense if the index changes in the innermost loop
+	static constexpr bool prefetch = inner::found && idx_struct::signature::template all_accept<inner::dim>;
+
+	const IdxBag &idx;
+	top_struct top;
+
+	// the state of the indirectly accessed bag (`state` has the indices of `idx`)
+	template<class State>
+	constexpr auto indirect_state(State state) const noexcept {
+		return state.template with<index_in<Dim>>(std::size_t(idx[state]));
+	}
+
+	template<class IndirectBag, class State>
+	constexpr void prefetch_ahead(const IndirectBag &bag, State state) const noexcept {
+		if constexpr(prefetch) {
+			constexpr char dim = inner::dim;
+			std::size_t ahead = state.template get<index_in<dim>>() + gather_prefetch_distance;
+			if(ahead < top.template length<dim>(state.template remove<index_in<dim>>()))
+				gather_prefetch(&bag[indirect_state(state.template with<index_in<dim>>(ahead))]);
+		} else {
+			(void)bag;
+			(void)state;
+		}
+	}
+};
+
+} // namespace helpers
+
+/**
+ * @brief sets each element of `out` to the element of `in` whose index in `Dim` is given by the corresponding element of `idx`
+ *
+ * The bags `idx` and `out` are traversed together (so `out` has all the dimensions of `idx`). The remaining indices of `in`
+ * are taken from the same state (e.g. gathering rows: `in` has 'i' and 'j', `idx` has 'k', `out` has 'k' and 'j').
+ * The indirectly accessed elements are prefetched a few steps ahead.
+ *
+ * @tparam Dim: the dimension of `in` indexed by `idx` (`idx` and `out` may have it too, then it is just replaced)
+ * @param in: the source bag
+ * @param idx: the bag of indices
+ * @param out: the destination bag
+ */
+template<char Dim, class InBag, class IdxBag, class OutBag>
+constexpr void gather(const InBag &in, const IdxBag &idx, const OutBag &out) noexcept {
+	auto t = traverser(idx, out);
+	helpers::gather_impl<Dim, IdxBag, OutBag> impl{idx, t.top_struct()};
+	t.for_each([&in, &out, &impl](auto state) {
+		impl.prefetch_ahead(in, state);
+		out[state] = in[impl.indirect_state(state)];
+	});
+}
+
+/**
+ * @brief the inverse of `gather`: stores each element of `in` to the element of `out` whose index in `Dim` is given by `idx`
+ *
+ * If more elements are stored to the same place, the last one (in the traversal order) is kept.
+ *
+ * @tparam Dim: the dimension of `out` indexed by `idx`
+ */
+template<char Dim, class InBag, class IdxBag, class OutBag>
+constexpr void scatter(const InBag &in, const IdxBag &idx, const OutBag &out) noexcept {
+	auto t = traverser(idx, in);
+	helpers::gather_impl<Dim, IdxBag, InBag> impl{idx, t.top_struct()};
+	t.for_each([&in, &out, &impl](auto state) {
+		impl.prefetch_ahead(out, state);
+		out[impl.indirect_state(state)] = in[state];
+	});
+}
+
+/**
+ * @brief like `scatter`, but each element of `in` is combined with the current value in `out` using the reduction operation `op`
+ *
+ * For example, with `reduce_sum`, this is a scatter-add. Only the operations with `in_place` accumulators can be used.
+ */
+template<char Dim, class InBag, class IdxBag, class OutBag, class Op>
+constexpr void scatter(const InBag &in, const IdxBag &idx, const OutBag &out, Op op) noexcept {
+	static_assert(Op::in_place, "The operation must accumulate directly in the output");
+	auto t = traverser(idx, in);
+	helpers::gather_impl<Dim, IdxBag, InBag> impl{idx, t.top_struct()};
+	t.for_each([&in, &out, &impl, op](auto state) {
+		impl.prefetch_ahead(out, state);
+		op(out[impl.indirect_state(state)], in[state], 0);
+	});
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_GATHER_HPP
@@ -1,6 +1,11 @@
 #ifndef NOARR_STRUCTURES_MANGLE_HPP
 #define NOARR_STRUCTURES_MANGLE_HPP
 
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <tuple>
+
 #include "../base/contain.hpp"
 #include "../base/structs_common.hpp"
 #include "../base/utility.hpp"
@@ -180,6 +185,74 @@ struct mangle_expr_helpers {
 	}
 };
 
+// the inverse of `mangle_expr_helpers`, each `parse` consumes the representation of one value from the beginning of `in`
+struct unmangle_expr_helpers {
+	template<class T>
+	struct is_size_constant : std::false_type {};
+	template<std::size_t L>
+	struct is_size_constant<std::integral_constant<std::size_t, L>> : std::true_type {};
+
+	static constexpr bool consume(std::string_view &in, std::string_view prefix) noexcept {
+		if(in.substr(0, prefix.size()) != prefix)
+			return false;
+		in.remove_prefix(prefix.size());
+		return true;
+	}
+
+	// fails if the value does not fit in `T` (instead of wrapping around)
+	template<class T>
+	static constexpr bool parse_int(std::string_view &in, T &out) noexcept {
+		using unsigned_t = std::make_unsigned_t<T>;
+		bool neg = std::is_signed_v<T> && consume(in, "-");
+		const unsigned_t limit = unsigned_t(unsigned_t(std::numeric_limits<T>::max()) + neg);
+		unsigned_t u = 0;
+		std::size_t digits = 0;
+		while(digits < in.size() && in[digits] >= '0' && in[digits] <= '9') {
+			const unsigned_t digit = unsigned_t(in[digits++] - '0');
+			if(u > (limit - digit) / 10)
+				return false;
+			u = unsigned_t(u * 10 + digit);
+		}
+		if(digits == 0)
+			return false;
+		in.remove_prefix(digits);
+		out = T(neg ? unsigned_t(unsigned_t(0) - u) : u);
+		return true;
+	}
+
+	template<class T, std::size_t... Indices>
+	static constexpr std::optional<T> parse_items(std::string_view &in, std::index_sequence<Indices...>) {
+		std::tuple<std::optional<std::remove_cv_t<std::remove_reference_t<decltype(std::declval<const T &>().template get<Indices>())>>>...> items;
+		if(!(... && ((std::get<Indices>(items) = parse<std::remove_reference_t<decltype(*std::get<Indices>(items))>>(in)) && consume(in, ","))))
+			return std::nullopt;
+		return T(*std::get<Indices>(items)...);
+	}
+
+	template<class T>
+	static constexpr std::optional<T> parse(std::string_view &in) {
+		if constexpr(std::is_integral_v<T>) {
+			using type_str = char_seq_to_str<typename scalar_name<T>::type>;
+			T value = 0;
+			if(!consume(in, std::string_view(type_str::c_str, type_str::length)) || !consume(in, "{") || !parse_int(in, value) || !consume(in, "}"))
+				return std::nullopt;
+			return value;
+		} else if constexpr(is_size_constant<T>::value) {
+			std::size_t value = 0;
+			if(!consume(in, "lit<") || !parse_int(in, value) || !consume(in, ">") || value != T::value)
+				return std::nullopt;
+			return T();
+		} else {
+			using type_str = mangle_to_str<T>;
+			if(!consume(in, std::string_view(type_str::c_str, type_str::length)) || !consume(in, "{"))
+				return std::nullopt;
+			auto t = parse_items<T>(in, decltype(mangle_expr_helpers::get_contain_indices(std::declval<T>()))());
+			if(!t || !consume(in, "}"))
+				return std::nullopt;
+			return t;
+		}
+	}
+};
+
 } // namespace helpers
 
 template<class String, class T>
@@ -189,6 +262,19 @@ constexpr String mangle_expr(const T &t) {
 	return out;
 }
 
+/**
+ * @brief reconstructs a structure of type `T` from its description by `mangle_expr`
+ *
+ * @return the structure, or nothing if the description does not match the type `T` (or is malformed)
+ */
+template<class T>
+constexpr std::optional<T> unmangle_expr(std::string_view description) {
+	auto t = helpers::unmangle_expr_helpers::parse<T>(description);
+	if(!description.empty())
+		return std::nullopt;
+	return t;
+}
+
 } // namespace noarr
 
 #endif // NOARR_STRUCTURES_MANGLE_HPP
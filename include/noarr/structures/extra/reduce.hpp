@@ -0,0 +1,210 @@
+#ifndef NOARR_STRUCTURES_REDUCE_HPP
+#define NOARR_STRUCTURES_REDUCE_HPP
+
+#include <cstddef>
+#include <limits>
+
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../base/utility.hpp"
+#include "../extra/struct_traits.hpp"
+#include "../extra/to_struct.hpp"
+#include "../extra/traverser.hpp"
+
+namespace noarr {
+
+// Reduction operations
+//
+// An operation provides:
+// - `neutral<In, Out>()`: the initial accumulator
+// - `operator()(acc, value, index)`: folds one input value (found at `index` in the reduced dimension) into the accumulator
+// - `result<Out>(acc)`: converts the accumulator to the output value
+// - `in_place`: whether the accumulator is the output value itself (so it can be kept directly in the output structure)
+
+struct reduce_sum {
+	static constexpr bool in_place = true;
+
+	template<class In, class Out>
+	constexpr Out neutral() const noexcept { return Out(0); }
+
+	template<class Out, class In>
+	constexpr void operator()(Out &acc, const In &value, std::size_t) const noexcept { acc += value; }
+
+	template<class Out>
+	constexpr Out result(const Out &acc) const noexcept { return acc; }
+};
+
+struct reduce_min {
+	static constexpr bool in_place = true;
+
+	template<class In, class Out>
+	constexpr Out neutral() const noexcept { return std::numeric_limits<Out>::max(); }
+
+	template<class Out, class In>
+	constexpr void operator()(Out &acc, const In &value, std::size_t) const noexcept { if(value < acc) acc = value; }
+
+	template<class Out>
+	constexpr Out result(const Out &acc) const noexcept { return acc; }
+};
+
+struct reduce_max {
+	static constexpr bool in_place = true;
+
+	template<class In, class Out>
+	constexpr Out neutral() const noexcept { return std::numeric_limits<Out>::lowest(); }
+
+	template<class Out, class In>
+	constexpr void operator()(Out &acc, const In &value, std::size_t) const noexcept { if(acc < value) acc = value; }
+
+	template<class Out>
+	constexpr Out result(const Out &acc) const noexcept { return acc; }
+};
+
+/**
+ * @brief compensated (Kahan) summation, the rounding error of each addition is carried over to the next one
+ */
+struct reduce_kahan_sum {
+	static constexpr bool in_place = false;
+
+	template<class T>
+	struct accumulator {
+		T sum;
+		T compensation;
+	};
+
+	template<class In, class Out>
+	constexpr accumulator<Out> neutral() const noexcept { return {Out(0), Out(0)}; }
+
+	template<class Out, class In>
+	constexpr void operator()(accumulator<Out> &acc, const In &value, std::size_t) const noexcept {
+		Out y = value - acc.compensation;
+		Out t = acc.sum + y;
+		acc.compensation = (t - acc.sum) - y;
+		acc.sum = t;
+	}
+
+	template<class Out>
+	constexpr Out result(const accumulator<Out> &acc) const noexcept { return acc.sum; }
+};
+
+/**
+ * @brief finds the index of the first minimum, the output must be an integral type
+ */
+struct reduce_argmin {
+	static constexpr bool in_place = false;
+
+	template<class T>
+	struct accumulator {
+		T best;
+		std::size_t index;
+	};
+
+	template<class In, class Out>
+	constexpr accumulator<In> neutral() const noexcept { return {std::numeric_limits<In>::max(), 0}; }
+
+	template<class T, class In>
+	constexpr void operator()(accumulator<T> &acc, const In &value, std::size_t index) const noexcept { if(value < acc.best) acc = {value, index}; }
+
+	template<class Out, class T>
+	constexpr Out result(const accumulator<T> &acc) const noexcept { return Out(acc.index); }
+};
+
+/**
+ * @brief finds the index of the first maximum, the output must be an integral type
+ */
+struct reduce_argmax {
+	static constexpr bool in_place = false;
+
+	template<class T>
+	struct accumulator {
+		T best;
+		std::size_t index;
+	};
+
+	template<class In, class Out>
+	constexpr accumulator<In> neutral() const noexcept { return {std::numeric_limits<In>::lowest(), 0}; }
+
+	template<class T, class In>
+	constexpr void operator()(accumulator<T> &acc, const In &value, std::size_t index) const noexcept { if(acc.best < value) acc = {value, index}; }
+
+	template<class Out, class T>
+	constexpr Out result(const accumulator<T> &acc) const noexcept { return Out(acc.index); }
+};
+
+namespace helpers {
+
+template<char QDim, class Signature>
+struct reduce_sig_innermost : std::false_type {};
+template<char QDim, class ArgLength, class ValueType>
+struct reduce_sig_innermost<QDim, function_sig<QDim, ArgLength, scalar_sig<ValueType>>> : std::true_type {};
+template<char QDim, char Dim, class ArgLength, class RetSig>
+struct reduce_sig_innermost<QDim, function_sig<Dim, ArgLength, RetSig>> : reduce_sig_innermost<QDim, RetSig> {};
+
+template<char Dim, class InBag, class OutBag, class Op>
+struct reduce_along_impl {
+	using in_struct = typename to_struct<InBag>::type;
+	using out_struct = typename to_struct<OutBag>::type;
+	using in_t = scalar_t<in_struct>;
+	using out_t = scalar_t<out_struct>;
+
+	static_assert(in_struct::signature::template any_accept<Dim>, "The input structure does not have the reduced dimension");
+	static_assert(!out_struct::signature::template any_accept<Dim>, "The output structure must not have the reduced dimension");
+
+	// Accumulate in a local variable with the reduced dimension innermost, unless the accumulator can live in the output
+	// and the traversal in the input layout order would jump over the reduced dimension on every step anyway.
+	static constexpr bool accumulate_locally = !Op::in_place || reduce_sig_innermost<Dim, typename in_struct::signature>::value;
+
+	const InBag &in;
+	const OutBag &out;
+	Op op;
+
+	// the whole reduction for one output element (`state` has the indices of the output)
+	template<class State>
+	constexpr void reduce_one(State state) const noexcept {
+		auto acc = op.template neutral<in_t, out_t>();
+		std::size_t len = to_struct<InBag>::convert(in).template length<Dim>(state);
+		for(std::size_t i = 0; i < len; i++)
+			op(acc, in[state.template with<index_in<Dim>>(i)], i);
+		out[state] = op.template result<out_t>(acc);
+	}
+
+	template<class State>
+	constexpr void init_one(State state) const noexcept {
+		out[state] = op.template neutral<in_t, out_t>();
+	}
+
+	// one step of the reduction (`state` has the indices of the input)
+	template<class State>
+	constexpr void accumulate_one(State state) const noexcept {
+		op(out[state], in[state], state.template get<index_in<Dim>>());
+	}
+};
+
+} // namespace helpers
+
+/**
+ * @brief reduces the values of `in` along the dimension `Dim` into `out`, which must have all the remaining dimensions of `in`
+ *
+ * The loop order follows the layout of `in`: if `Dim` is its innermost dimension, each output element is reduced at once,
+ * otherwise the input is traversed in its order and the partial results are accumulated in `out` (if `op` allows it).
+ *
+ * @tparam Dim: the reduced dimension
+ * @param in: the input bag
+ * @param out: the output bag
+ * @param op: the reduction operation (e.g. `reduce_sum`)
+ */
+template<char Dim, class InBag, class OutBag, class Op>
+constexpr void reduce_along(const InBag &in, const OutBag &out, Op op) noexcept {
+	using impl_t = helpers::reduce_along_impl<Dim, InBag, OutBag, Op>;
+	impl_t impl{in, out, op};
+	if constexpr(impl_t::accumulate_locally) {
+		traverser(out).for_each([&impl](auto state) { impl.reduce_one(state); });
+	} else {
+		traverser(out).for_each([&impl](auto state) { impl.init_one(state); });
+		traverser(in, out).for_each([&impl](auto state) { impl.accumulate_one(state); });
+	}
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_REDUCE_HPP
@@ -0,0 +1,112 @@
+#ifndef NOARR_STRUCTURES_SHUFFLE_HPP
+#define NOARR_STRUCTURES_SHUFFLE_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include "../base/state.hpp"
+#include "../extra/funcs.hpp"
+#include "../extra/struct_traits.hpp"
+#include "../extra/traverser.hpp"
+#include "../structs/bytes.hpp"
+#include "../structs/slice.hpp"
+
+namespace noarr {
+
+namespace helpers {
+
+template<bool Unshuffle, class Struct>
+constexpr void byte_shuffle_copy(Struct s, const void *src, void *dst) noexcept {
+	// the same mapping as between `s ^ as_bytes<Dim>()` and `s ^ byte_planes<Dim>()`, with the offsets computed once per element
+	constexpr std::size_t elem_size = sizeof(scalar_t<Struct>);
+	const std::size_t plane_size = (s | get_size()) / elem_size;
+	const auto *in = static_cast<const unsigned char *>(src);
+	auto *out = static_cast<unsigned char *>(dst);
+
+	traverser(s).for_each([&](auto state) {
+		const std::size_t elem = s | offset(state);
+		const std::size_t plane_elem = elem / elem_size;
+		for(std::size_t b = 0; b < elem_size; b++) {
+			if constexpr(Unshuffle)
+				out[elem + b] = in[b * plane_size + plane_elem];
+			else
+				out[b * plane_size + plane_elem] = in[elem + b];
+		}
+	});
+}
+
+} // namespace helpers
+
+/**
+ * @brief copies the elements of a structure from `src` to `dst`, storing their bytes in planes (see `byte_planes`)
+ *
+ * `dst` must have `s | get_size()` bytes. Shuffling the bytes of numbers before compression (the most significant bytes usually repeat) improves the compression ratio.
+ *
+ * @param s: the structure of `src` (without tuples)
+ */
+template<class Struct>
+constexpr void byte_shuffle(Struct s, const void *src, void *dst) noexcept {
+	helpers::byte_shuffle_copy<false>(s, src, dst);
+}
+
+/**
+ * @brief the inverse of `byte_shuffle`: copies the byte planes from `src` to the elements of a structure in `dst`
+ *
+ * @param s: the structure of `dst` (without tuples)
+ */
+template<class Struct>
+constexpr void byte_unshuffle(Struct s, const void *src, void *dst) noexcept {
+	helpers::byte_shuffle_copy<true>(s, src, dst);
+}
+
+/**
+ * @brief replaces each element of a structure (in place) by its difference from the previous element along a dimension (the first element is kept)
+ *
+ * The elements must be of an unsigned integral type, so the differences wrap around and the encoding is lossless
+ * (floating-point data can be encoded as their byte planes: `s ^ byte_planes<'b'>()`).
+ *
+ * @tparam Dim: the dimension along which the differences are computed
+ * @param s: the structure of `data`
+ */
+template<char Dim, class Struct>
+constexpr void delta_encode(Struct s, void *data) noexcept {
+	using value_type = scalar_t<Struct>;
+	static_assert(std::is_integral_v<value_type> && std::is_unsigned_v<value_type>, "Delta encoding is only lossless for unsigned integers");
+	auto *bytes = static_cast<char *>(data);
+
+	// each element is replaced before the previous one is
+	traverser(s).order(reverse<Dim>()).for_each([&](auto state) {
+		const std::size_t i = state.template get<index_in<Dim>>();
+		if(i == 0)
+			return;
+		auto &elem = *reinterpret_cast<value_type *>(bytes + (s | offset(state)));
+		const auto &prev = *reinterpret_cast<const value_type *>(bytes + (s | offset(state.template with<index_in<Dim>>(i - 1))));
+		elem = value_type(elem - prev);
+	});
+}
+
+/**
+ * @brief the inverse of `delta_encode`: replaces each element of a structure (in place) by the sum of the elements up to it along a dimension
+ *
+ * @tparam Dim: the dimension along which the differences were computed
+ * @param s: the structure of `data`
+ */
+template<char Dim, class Struct>
+constexpr void delta_decode(Struct s, void *data) noexcept {
+	using value_type = scalar_t<Struct>;
+	static_assert(std::is_integral_v<value_type> && std::is_unsigned_v<value_type>, "Delta encoding is only lossless for unsigned integers");
+	auto *bytes = static_cast<char *>(data);
+
+	traverser(s).for_each([&](auto state) {
+		const std::size_t i = state.template get<index_in<Dim>>();
+		if(i == 0)
+			return;
+		auto &elem = *reinterpret_cast<value_type *>(bytes + (s | offset(state)));
+		const auto &prev = *reinterpret_cast<const value_type *>(bytes + (s | offset(state.template with<index_in<Dim>>(i - 1))));
+		elem = value_type(elem + prev);
+	});
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_SHUFFLE_HPP
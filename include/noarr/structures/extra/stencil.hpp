@@ -0,0 +1,332 @@
+#ifndef NOARR_STRUCTURES_STENCIL_HPP
+#define NOARR_STRUCTURES_STENCIL_HPP
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "../base/contain.hpp"
+#include "../base/utility.hpp"
+#include "../extra/to_struct.hpp"
+#include "../extra/traverser.hpp"
+#include "../structs/pad.hpp"
+#include "../structs/setters.hpp"
+#include "../structs/slice.hpp"
+
+namespace noarr {
+
+namespace helpers {
+
+// the range of indices in one dimension where the whole neighborhood is in bounds (never inverted, may be empty)
+struct stencil_bounds {
+	std::size_t begin;
+	std::size_t end;
+	std::size_t length;
+
+	static constexpr stencil_bounds make(std::size_t length, std::size_t radius) noexcept {
+		std::size_t begin = radius < length ? radius : length;
+		std::size_t end = length - begin > begin ? length - begin : begin;
+		return {begin, end, length};
+	}
+};
+
+struct stencil_tiling {
+	std::size_t begin;
+	std::size_t end;
+	std::size_t tile;
+
+	constexpr std::size_t count() const noexcept { return (end - begin + tile - 1) / tile; }
+};
+
+} // namespace helpers
+
+/**
+ * @brief the interior of a traversal split into rectangular tiles, see `stencil_t::tiles`
+ *
+ * @tparam Traverser: the original traverser
+ * @tparam Dims: the tiled dimensions, the first one varies fastest in the tile order
+ */
+template<class Traverser, char... Dims>
+struct stencil_tiles_t : contain<Traverser, std::array<helpers::stencil_tiling, sizeof...(Dims)>> {
+	using base = contain<Traverser, std::array<helpers::stencil_tiling, sizeof...(Dims)>>;
+	using base::base;
+
+	constexpr Traverser get_traverser() const noexcept { return base::template get<0>(); }
+	constexpr std::array<helpers::stencil_tiling, sizeof...(Dims)> tilings() const noexcept { return base::template get<1>(); }
+
+	constexpr std::size_t size() const noexcept {
+		std::size_t size = 1;
+		for(const auto &tiling : tilings())
+			size *= tiling.count();
+		return size;
+	}
+
+	/**
+	 * @brief returns the traverser of the `i`-th tile (all tiles have the same type)
+	 */
+	constexpr auto operator[](std::size_t i) const noexcept {
+		return tile_at(i, std::make_index_sequence<sizeof...(Dims)>());
+	}
+
+	/**
+	 * @brief calls `f` for each state of the interior, tile by tile
+	 */
+	template<class F>
+	constexpr void for_each(F f) const noexcept {
+		std::size_t n = size();
+		for(std::size_t i = 0; i < n; i++)
+			(*this)[i].for_each(f);
+	}
+
+private:
+	template<char Dim, std::size_t I>
+	constexpr auto tile_span(std::size_t i) const noexcept {
+		auto all = tilings();
+		for(std::size_t j = 0; j < I; j++)
+			i /= all[j].count();
+		const auto &tiling = all[I];
+		std::size_t begin = tiling.begin + i % tiling.count() * tiling.tile;
+		std::size_t end = tiling.end - begin > tiling.tile ? begin + tiling.tile : tiling.end;
+		return span<Dim>(begin, end);
+	}
+
+	template<std::size_t... I>
+	constexpr auto tile_at(std::size_t i, std::index_sequence<I...>) const noexcept {
+		return get_traverser().order((... ^ tile_span<Dims, I>(i)));
+	}
+};
+
+/**
+ * @brief describes the neighborhood of a stencil (its radius in each dimension) and splits traversals accordingly
+ *
+ * The interior is the part of a traversal where `neighbor` may be used with any offset within the radius,
+ * the boundary is the rest. Both are expressed as traversals (restricted by `span`), so the states passed to `f`
+ * are always in the coordinates of the original traverser.
+ *
+ * @tparam Dims: the dimensions in which the stencil reaches to the neighbors
+ */
+template<char... Dims>
+struct stencil_t : contain<std::enable_if_t<true || Dims, std::size_t>...> {
+	using base = contain<std::enable_if_t<true || Dims, std::size_t>...>;
+	using base::base;
+
+	template<std::size_t I>
+	constexpr std::size_t radius() const noexcept { return base::template get<I>(); }
+
+	/**
+	 * @brief restricts the traverser `t` to the interior
+	 */
+	template<class Traverser>
+	constexpr auto interior(const Traverser &t) const noexcept {
+		return interior_impl(t, std::make_index_sequence<sizeof...(Dims)>());
+	}
+
+	/**
+	 * @brief calls `f` for each state of `t` that is not in the interior
+	 *
+	 * The boundary is split into disjoint slabs, two for each dimension (at its beginning and at its end).
+	 */
+	template<class Traverser, class F>
+	constexpr void for_each_boundary(const Traverser &t, F f) const noexcept {
+		for_each_boundary_impl(t, f, std::make_index_sequence<sizeof...(Dims)>());
+	}
+
+	/**
+	 * @brief splits the interior of `t` into tiles of the given sizes (the last ones in each dimension may be smaller, a zero size is treated as one)
+	 *
+	 * Each tile reads its halo (the `radius` neighboring elements) from the adjacent tiles or the boundary.
+	 */
+	template<class Traverser>
+	constexpr auto tiles(const Traverser &t, std::enable_if_t<true || Dims, std::size_t>... tile_sizes) const noexcept {
+		return tiles_impl(t, std::make_index_sequence<sizeof...(Dims)>(), tile_sizes...);
+	}
+
+private:
+	template<char Dim, std::size_t I, class Traverser>
+	constexpr helpers::stencil_bounds bounds(const Traverser &t) const noexcept {
+		return helpers::stencil_bounds::make(t.top_struct().template length<Dim>(empty_state), radius<I>());
+	}
+
+	template<char Dim, std::size_t I, class Traverser>
+	constexpr auto interior_span(const Traverser &t) const noexcept {
+		auto b = bounds<Dim, I>(t);
+		return span<Dim>(b.begin, b.end);
+	}
+
+	template<class Traverser, std::size_t... I>
+	constexpr auto interior_impl(const Traverser &t, std::index_sequence<I...>) const noexcept {
+		return t.order((neutral_proto() ^ ... ^ interior_span<Dims, I>(t)));
+	}
+
+	// the slab in dimension number `K`: interior in the preceding dimensions, unrestricted in the following ones
+	template<std::size_t K, char Dim, std::size_t I, class Traverser>
+	constexpr auto slab_span(const Traverser &t, bool high) const noexcept {
+		auto b = bounds<Dim, I>(t);
+		if constexpr(I < K)
+			return span<Dim>(b.begin, b.end);
+		else if constexpr(I == K)
+			return high ? span<Dim>(b.end, b.length) : span<Dim>(std::size_t(0), b.begin);
+		else
+			return neutral_proto();
+	}
+
+	template<std::size_t K, class Traverser, class F, std::size_t... I>
+	constexpr void for_each_slab(const Traverser &t, F f, std::index_sequence<I...>) const noexcept {
+		t.order((neutral_proto() ^ ... ^ slab_span<K, Dims, I>(t, false))).for_each(f);
+		t.order((neutral_proto() ^ ... ^ slab_span<K, Dims, I>(t, true))).for_each(f);
+	}
+
+	template<class Traverser, class F, std::size_t... K>
+	constexpr void for_each_boundary_impl(const Traverser &t, F f, std::index_sequence<K...> is) const noexcept {
+		(..., for_each_slab<K>(t, f, is));
+	}
+
+	template<class Traverser, std::size_t... I>
+	constexpr auto tiles_impl(const Traverser &t, std::index_sequence<I...>, std::enable_if_t<true || Dims, std::size_t>... tile_sizes) const noexcept {
+		using tiles_t = stencil_tiles_t<Traverser, Dims...>;
+		return tiles_t(t, std::array<helpers::stencil_tiling, sizeof...(Dims)>{
+			// a zero tile size would give no tiles (and divide by zero), it is treated as one
+			helpers::stencil_tiling{bounds<Dims, I>(t).begin, bounds<Dims, I>(t).end, tile_sizes ? tile_sizes : 1}...
+		});
+	}
+};
+
+/**
+ * @brief creates a stencil reaching `radii` elements in each of the dimensions `Dims` (in both directions)
+ */
+template<char... Dims>
+constexpr auto stencil(std::enable_if_t<true || Dims, std::size_t>... radii) noexcept {
+	return stencil_t<Dims...>(radii...);
+}
+
+namespace helpers {
+
+struct halo_periodic_policy {
+	static constexpr bool is_constant = false;
+
+	static constexpr std::size_t source(std::size_t index, std::size_t length) noexcept {
+		const std::ptrdiff_t i = std::ptrdiff_t(index), n = std::ptrdiff_t(length);
+		const std::ptrdiff_t r = i % n;
+		return std::size_t(r < 0 ? r + n : r);
+	}
+};
+
+struct halo_clamp_policy {
+	static constexpr bool is_constant = false;
+
+	static constexpr std::size_t source(std::size_t index, std::size_t length) noexcept {
+		const std::ptrdiff_t i = std::ptrdiff_t(index), n = std::ptrdiff_t(length);
+		return std::size_t(i < 0 ? 0 : i >= n ? n - 1 : i);
+	}
+};
+
+template<class T>
+struct halo_constant_policy {
+	static constexpr bool is_constant = true;
+
+	T value;
+};
+
+struct halo_serial_for {
+	template<class F>
+	void operator()(std::size_t count, const F &f) const {
+		for(std::size_t i = 0; i < count; i++)
+			f(i);
+	}
+};
+
+// fills the halo of the padded dimensions, the halo is split into disjoint slabs, one for each dimension:
+// the slab of the dimension number `K` covers its halo, the whole extent (with the halo) of the preceding dimensions and the interior of the following ones
+template<char... Dims>
+struct halo_filler {
+	static constexpr std::size_t num_dims = sizeof...(Dims);
+	static constexpr char dims[] = {Dims...};
+
+	std::size_t length[num_dims];
+	pad_extent extent[num_dims];
+
+	template<std::size_t K, std::size_t I>
+	static constexpr auto fix_slab(std::size_t index) noexcept {
+		if constexpr(I <= K)
+			return fix<dims[I]>(index);
+		else
+			return neutral_proto();
+	}
+
+	template<std::size_t K, class Bag, class Policy, class ForRange, std::size_t... I>
+	void fill_slab(const Bag &bag, const Policy &policy, const ForRange &for_range, std::index_sequence<I...>) const {
+		const std::size_t halo = extent[K].before + extent[K].after;
+		if(halo == 0)
+			return;
+		std::size_t count = halo;
+		for(std::size_t j = 0; j < K; j++)
+			count *= extent[j].before + length[j] + extent[j].after;
+
+		for_range(count, [&](std::size_t c) {
+			std::size_t index[num_dims] = {};
+			const std::size_t h = c % halo;
+			c /= halo;
+			index[K] = h < extent[K].before ? h - extent[K].before : length[K] + (h - extent[K].before); // negative indices wrap
+			for(std::size_t j = 0; j < K; j++) {
+				const std::size_t full = extent[j].before + length[j] + extent[j].after;
+				index[j] = c % full - extent[j].before;
+				c /= full;
+			}
+			traverser(bag).order((neutral_proto() ^ ... ^ fix_slab<K, I>(index[I]))).for_each([&](auto state) {
+				if constexpr(Policy::is_constant)
+					bag[state] = policy.value;
+				else
+					bag[state] = bag[state.template with<index_in<Dims>...>(Policy::source(state.template get<index_in<Dims>>(), length[I])...)];
+			});
+		});
+	}
+
+	template<class Bag, class Policy, class ForRange, std::size_t... I>
+	void fill(const Bag &bag, const Policy &policy, const ForRange &for_range, std::index_sequence<I...> is) const {
+		(..., fill_slab<I>(bag, policy, for_range, is));
+	}
+};
+
+template<char... Dims, class Bag, class Policy, class ForRange>
+void fill_halo(const Bag &bag, const Policy &policy, const ForRange &for_range) {
+	const auto structure = to_struct<Bag>::convert(bag);
+	const halo_filler<Dims...> filler = {
+		{std::size_t(structure | get_length<Dims>())...},
+		{get_pad_extent<Dims>(structure)...},
+	};
+	filler.fill(bag, policy, for_range, std::make_index_sequence<sizeof...(Dims)>());
+}
+
+} // namespace helpers
+
+/**
+ * @brief the halo policy for `fill_halo`: the halo is a copy of the opposite side of the interior (periodic boundary)
+ */
+constexpr auto pad_periodic() noexcept { return helpers::halo_periodic_policy(); }
+
+/**
+ * @brief the halo policy for `fill_halo`: the halo is a copy of the nearest interior element
+ */
+constexpr auto pad_clamp() noexcept { return helpers::halo_clamp_policy(); }
+
+/**
+ * @brief the halo policy for `fill_halo`: the halo is filled with `value`
+ */
+template<class T>
+constexpr auto pad_constant(T value) noexcept { return helpers::halo_constant_policy<T>{value}; }
+
+/**
+ * @brief fills the halo of a bag padded (using `pad`) in the dimensions `Dims` according to the `policy` (`pad_periodic`, `pad_clamp`, or `pad_constant`)
+ *
+ * Each halo element is computed from the interior only, so the order does not matter (`tbb_fill_halo` fills the halo in parallel).
+ * The other dimensions of the bag are traversed too.
+ */
+template<char... Dims, class Bag, class Policy>
+void fill_halo(const Bag &bag, const Policy &policy) {
+	helpers::fill_halo<Dims...>(bag, policy, helpers::halo_serial_for());
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_STENCIL_HPP
@@ -13,6 +13,77 @@ namespace noarr {
 
 namespace helpers {
 
+template<class Orig, class ArgLength>
+constexpr bool arg_lengths_compatible() noexcept {
+	if constexpr(Orig::is_static && ArgLength::is_static)
+		return Orig::value == ArgLength::value;
+	else
+		return true;
+}
+
+// the more precise of two lengths of the same dimension (static, then dynamic, then unknown)
+template<class Orig, class ArgLength>
+using arg_length_union_t = std::conditional_t<Orig::is_static || !ArgLength::is_known || (Orig::is_known && !ArgLength::is_static), Orig, ArgLength>;
+
+// updates the length of `Dim` in `Sig` (in all the tuple branches that have the dimension)
+template<class Sig, char Dim, class ArgLength>
+struct sig_union_length;
+template<char Dim, class OrigLength, class RetSig, class ArgLength>
+struct sig_union_length<function_sig<Dim, OrigLength, RetSig>, Dim, ArgLength> {
+	static_assert(arg_lengths_compatible<OrigLength, ArgLength>(), "The structures have different (static) lengths in a dimension");
+	using type = function_sig<Dim, arg_length_union_t<OrigLength, ArgLength>, RetSig>;
+};
+template<char QDim, class OrigLength, class RetSig, char Dim, class ArgLength>
+struct sig_union_length<function_sig<QDim, OrigLength, RetSig>, Dim, ArgLength> {
+	using type = function_sig<QDim, OrigLength, typename sig_union_length<RetSig, Dim, ArgLength>::type>;
+};
+template<char Dim, class... RetSigs, class ArgLength>
+struct sig_union_length<dep_function_sig<Dim, RetSigs...>, Dim, ArgLength> {
+	static_assert(value_always_false<Dim>, "A dimension cannot be a tuple in one structure and a vector in another");
+};
+template<char QDim, class... RetSigs, char Dim, class ArgLength>
+struct sig_union_length<dep_function_sig<QDim, RetSigs...>, Dim, ArgLength> {
+	using type = dep_function_sig<QDim, typename sig_union_length<RetSigs, Dim, ArgLength>::type...>;
+};
+template<class ValueType, char Dim, class ArgLength>
+struct sig_union_length<scalar_sig<ValueType>, Dim, ArgLength> {
+	using type = scalar_sig<ValueType>;
+};
+
+// checks that the tuple dimension `Dim` has `Len` branches in `Sig` (in all the tuple branches that have the dimension)
+template<class Sig, char Dim, std::size_t Len>
+struct sig_union_tuple_check : std::true_type {};
+template<char Dim, class ArgLength, class RetSig, std::size_t Len>
+struct sig_union_tuple_check<function_sig<Dim, ArgLength, RetSig>, Dim, Len> {
+	static_assert(value_always_false<Dim>, "A dimension cannot be a tuple in one structure and a vector in another");
+};
+template<char QDim, class ArgLength, class RetSig, char Dim, std::size_t Len>
+struct sig_union_tuple_check<function_sig<QDim, ArgLength, RetSig>, Dim, Len> : sig_union_tuple_check<RetSig, Dim, Len> {};
+template<char Dim, class... RetSigs, std::size_t Len>
+struct sig_union_tuple_check<dep_function_sig<Dim, RetSigs...>, Dim, Len> : std::true_type {
+	static_assert(sizeof...(RetSigs) == Len, "The structures have tuples of different lengths in a dimension");
+};
+template<char QDim, class... RetSigs, char Dim, std::size_t Len>
+struct sig_union_tuple_check<dep_function_sig<QDim, RetSigs...>, Dim, Len> : std::bool_constant<(... && sig_union_tuple_check<RetSigs, Dim, Len>::value)> {};
+
+// whether the length of `QDim` is known in the signature (without going into the tuples whose index is not in the state)
+template<char QDim, class State, class Signature>
+struct sig_length_known : std::false_type {};
+template<char QDim, class State, class ArgLength, class RetSig>
+struct sig_length_known<QDim, State, function_sig<QDim, ArgLength, RetSig>> : std::bool_constant<ArgLength::is_known> {};
+template<char QDim, class State, char Dim, class ArgLength, class RetSig>
+struct sig_length_known<QDim, State, function_sig<Dim, ArgLength, RetSig>> : sig_length_known<QDim, State, RetSig> {};
+template<char QDim, class State, class... RetSigs>
+struct sig_length_known<QDim, State, dep_function_sig<QDim, RetSigs...>> : std::true_type {};
+template<char QDim, class State, char Dim, class... RetSigs>
+struct sig_length_known<QDim, State, dep_function_sig<Dim, RetSigs...>> {
+	template<bool = State::template contains<index_in<Dim>>, class = void>
+	struct branch : std::false_type {};
+	template<class Useless>
+	struct branch<true, Useless> : sig_length_known<QDim, State, typename dep_function_sig<Dim, RetSigs...>::template ret_sig<state_get_t<State, index_in<Dim>>::value>> {};
+	static constexpr bool value = branch<>::value;
+};
+
 template<class Sig1, class Sig2>
 struct sig_union2;
 template<class Sig1, char Dim, class ArgLength, class RetSig>
@@ -21,15 +92,26 @@ struct sig_union2<Sig1, function_sig<Dim, ArgLength, RetSig>> {
 	template<bool = Sig1::template any_accept<Dim>, class = void>
 	struct ty;
 	template<class Useless>
-	struct ty<true, Useless> { using pe = ret; }; // TODO ArgLength union
+	struct ty<true, Useless> { using pe = typename sig_union_length<ret, Dim, ArgLength>::type; };
 	template<class Useless>
 	struct ty<false, Useless> { using pe = function_sig<Dim, ArgLength, ret>; };
 	using type = typename ty<>::pe;
 };
 template<class Sig1, char Dim, class... RetSigs>
 struct sig_union2<Sig1, dep_function_sig<Dim, RetSigs...>> {
-	// TODO
-	static_assert(value_always_false<Dim>, "Unsupported");
+	template<bool = Sig1::template any_accept<Dim>, class = void>
+	struct ty;
+	template<class Useless>
+	struct ty<true, Useless> {
+		// the tuple is already present, the branches may only add information about the existing dimensions (or add the same dimensions)
+		static_assert(sig_union_tuple_check<Sig1, Dim, sizeof...(RetSigs)>::value);
+		using branches = std::tuple<typename sig_union2<Sig1, RetSigs>::type..., Sig1>; // (Sig1 for an empty tuple)
+		static_assert((... && std::is_same_v<typename sig_union2<Sig1, RetSigs>::type, std::tuple_element_t<0, branches>>), "The branches of a tuple cannot add different dimensions to a traversal");
+		using pe = std::tuple_element_t<0, branches>;
+	};
+	template<class Useless>
+	struct ty<false, Useless> { using pe = dep_function_sig<Dim, typename sig_union2<Sig1, RetSigs>::type...>; };
+	using type = typename ty<>::pe;
 };
 template<class Sig1, class ValueType>
 struct sig_union2<Sig1, scalar_sig<ValueType>> {
@@ -47,33 +129,54 @@ struct sig_union<Sig> {
 	using type = Sig;
 };
 
+// whether the length of `Dim` in `Struct` depends on the indices in the other dimensions (e.g. a line of a triangle),
+// the structures that have such a length declare `dependent_length<Dim>`, the structures that wrap them are looked through
+template<char Dim, class Struct, class = void>
+struct has_dependent_length;
+
+template<char Dim, class Struct, class = void>
+struct sub_has_dependent_length : std::false_type {};
+template<char Dim, class Struct>
+struct sub_has_dependent_length<Dim, Struct, std::void_t<decltype(std::declval<Struct>().sub_structure())>>
+	: has_dependent_length<Dim, decltype(std::declval<Struct>().sub_structure())> {};
+
+template<char Dim, class Struct, class>
+struct has_dependent_length : sub_has_dependent_length<Dim, Struct> {};
+template<char Dim, class Struct>
+struct has_dependent_length<Dim, Struct, std::void_t<decltype(Struct::template dependent_length<Dim>)>>
+	: std::bool_constant<Struct::template dependent_length<Dim>> {};
+
+template<class Signature, class StateItem>
+struct union_accepts : std::false_type {};
+template<class Signature, char Dim, class ValueType>
+struct union_accepts<Signature, state_item<index_in<Dim>, ValueType>> : std::bool_constant<Signature::template any_accept<Dim>> {};
+template<class Signature, char Dim, class ValueType>
+struct union_accepts<Signature, state_item<length_in<Dim>, ValueType>> : std::bool_constant<Signature::template any_accept<Dim>> {};
+
 template<class Signature, class State>
 struct union_filter_accepted;
-template<class Signature, class HeadStateItem, class... TailStateItems>
-struct union_filter_accepted<Signature, state<HeadStateItem, TailStateItems...>> {
-	using tail = typename union_filter_accepted<Signature, state<TailStateItems...>>::template res<>::ult;
-	template<class = HeadStateItem, class = void>
-	struct res {
-		using ult = tail;
-	};
-	template<char Dim, class ValueType>
-	struct res<state_item<index_in<Dim>, ValueType>, std::enable_if_t<Signature::template any_accept<Dim>>> {
-		using ult = typename tail::template prepend<HeadStateItem>;
-	};
-	template<char Dim, class ValueType>
-	struct res<state_item<length_in<Dim>, ValueType>, std::enable_if_t<Signature::template any_accept<Dim>>> {
-		using ult = typename tail::template prepend<HeadStateItem>;
-	};
-};
-template<class Signature>
-struct union_filter_accepted<Signature, state<>> {
+template<class Signature, class... StateItems>
+struct union_filter_accepted<Signature, state<StateItems...>> {
+	template<class StateItem>
+	using accepted = union_accepts<Signature, StateItem>;
 	template<class = void>
-	struct res { using ult = state_items_pack<>; };
+	struct res { using ult = state_items_filter<accepted, StateItems...>; };
 };
 
 template<class Struct, class State>
 using union_filter_accepted_t = typename union_filter_accepted<typename Struct::signature, State>::template res<>::ult;
 
+// wraps the function given to `traverser_t::for_each`, which is called with states instead of inner traversers
+template<class F>
+struct traverser_state_callback {
+	F f;
+};
+
+template<class F>
+struct is_traverser_state_callback : std::false_type {};
+template<class F>
+struct is_traverser_state_callback<traverser_state_callback<F>> : std::true_type {};
+
 } // namespace helpers
 
 template<class... Structs>
@@ -88,22 +191,34 @@ struct union_t : contain<Structs...> {
 	constexpr auto sub_structure() const noexcept { return base::template get<Index>(); }
 
 private:
-	template<char Dim, std::size_t I>
-	constexpr auto find_first_match() {
-		using sub_t = decltype(sub_structure<I>());
-		using sub_sig = typename sub_t::signature;
-		if constexpr(sub_sig::template any_accept<Dim>)
-			return std::integral_constant<std::size_t, I>();
+	template<char Dim>
+	static constexpr bool accepts[] = {Structs::signature::template any_accept<Dim>..., false};
+	template<char Dim>
+	static constexpr std::size_t first_match = helpers::find_first(accepts<Dim>);
+
+	template<char Dim, class State, class Signature>
+	static constexpr bool knows_length() noexcept {
+		if constexpr(State::template contains<length_in<Dim>>)
+			return Signature::template any_accept<Dim>;
 		else
-			return find_first_match<Dim, I+1>();
+			return helpers::sig_length_known<Dim, State, Signature>::value;
+	}
+
+	// the first structure whose length depends on the other indices (it limits the traversal to its elements, e.g. a triangle of a full matrix),
+	// otherwise the first structure that knows the length (if there is none, the first structure that has the dimension)
+	template<char Dim, class State>
+	static constexpr std::size_t length_match() noexcept {
+		constexpr bool dependent[] = {(!State::template contains<length_in<Dim>> && Structs::signature::template any_accept<Dim> && helpers::has_dependent_length<Dim, Structs>::value)..., false};
+		constexpr std::size_t first_dependent = helpers::find_first(dependent);
+		constexpr bool knows[] = {knows_length<Dim, State, typename Structs::signature>()..., false};
+		constexpr std::size_t first_known = helpers::find_first(knows);
+		return first_dependent < sizeof...(Structs) ? first_dependent : first_known < sizeof...(Structs) ? first_known : first_match<Dim>;
 	}
-	template<char Dim>
-	static constexpr std::size_t first_match = decltype(std::declval<union_t<Structs...>>().template find_first_match<Dim, 0>())::value;
 public:
 
 	template<char QDim, class State>
 	constexpr auto length(State state) const noexcept {
-		return base::template get<first_match<QDim>>().template length<QDim>(state);
+		return base::template get<length_match<QDim, State>()>().template length<QDim>(state);
 	}
 };
 
@@ -128,14 +243,15 @@ struct traverser_t : contain<Struct, Order> {
 		return traverser_t<Struct, decltype(get_order() ^ new_order)>(get_struct(), get_order() ^ new_order);
 	}
 
+	// the states are passed directly, without constructing the inner traversers (as in `for_sections`)
 	template<char Dim, char... Dims, class F>
 	constexpr void for_each(F f) const noexcept {
-		for_sections<Dim, Dims...>([f](auto inner) { return f(inner.state()); });
+		for_sections<Dim, Dims...>(helpers::traverser_state_callback<F>{f});
 	}
 
 	template<class F>
 	constexpr void for_each(F f) const noexcept {
-		for_sections([f](auto inner) { return f(inner.state()); });
+		for_sections(helpers::traverser_state_callback<F>{f});
 	}
 
 	// TODO add tests
@@ -192,18 +308,27 @@ private:
 			for_each_impl_dep<Dim, Branches...>(f, state, std::make_index_sequence<len>());
 		} else {
 			std::size_t len = top_struct().template length<Dim>(state);
-			for(std::size_t i = 0; i < len; i++)
-				for_each_impl(Branches()..., f, state.template with<index_in<Dim>>(i));
+			// the inner state is built once, the loop only updates its slot for `Dim`
+			auto inner = state.template with<index_in<Dim>>(std::size_t(0));
+			for(std::size_t i = 0; i < len; i++) {
+				inner.template get_ref<index_in<Dim>>() = i;
+				for_each_impl(Branches()..., f, inner);
+			}
 		}
 	}
+	template<class F, class State>
+	constexpr void for_each_impl(char_sequence<>, F f, State state) const noexcept {
+		if constexpr(helpers::is_traverser_state_callback<F>::value)
+			f.f(state_at<Struct>(top_struct(), state));
+		else if constexpr(State::is_empty)
+			f(*this);
+		else
+			for_section(f, state);
+	}
 	template<class F, char... Dims, class... IdxT>
-	constexpr void for_each_impl(char_sequence<>, F f, noarr::state<state_item<index_in<Dims>, IdxT>...> state) const noexcept {
+	constexpr void for_section(F f, noarr::state<state_item<index_in<Dims>, IdxT>...> state) const noexcept {
 		f(order((... ^ fix<Dims>(state.template get<index_in<Dims>>()))));
 	}
-	template<class F>
-	constexpr void for_each_impl(char_sequence<>, F f, noarr::state<>) const noexcept {
-		f(*this);
-	}
 };
 
 template<class... Ts>
@@ -0,0 +1,278 @@
+#ifndef NOARR_STRUCTURES_ASYNC_IO_HPP
+#define NOARR_STRUCTURES_ASYNC_IO_HPP
+
+// the asynchronous I/O works with POSIX file descriptors (and `pread` and `pwrite`), it is not available on Windows
+#ifdef _WIN32
+#error "async_io.hpp requires the POSIX pread and pwrite functions"
+#endif
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "../extra/funcs.hpp"
+#include "../extra/shortcuts.hpp"
+#include "../structs/setters.hpp"
+#include "bag.hpp"
+#include "parallel_io.hpp"
+
+namespace noarr {
+
+/**
+ * @brief a read or a write of (a prefix of) one of the buffers of an I/O backend
+ */
+struct io_request {
+	int fd;
+	bool write;
+	std::size_t buffer;
+	std::size_t size;
+	std::uint64_t offset;
+};
+
+// An I/O backend performs asynchronous reads and writes to a fixed set of buffers. It has the following interface:
+//
+// struct backend {
+// 	bool init(char *buffers, std::size_t buffer_size, std::size_t num_buffers, std::size_t queue_depth); // called once, the buffers are consecutive
+// 	bool submit(const io_request &request); // at most one request per buffer can be in progress
+// 	bool wait(std::size_t buffer);          // waits for the request on the buffer, returns whether it transferred all the bytes
+// };
+//
+// The backends are used from a single thread. See io_uring.hpp for a backend using the Linux io_uring interface.
+
+/**
+ * @brief an I/O backend executing the requests by a pool of threads (using `pread` and `pwrite`)
+ */
+class thread_io_backend {
+	enum class status : char { idle, pending, done, failed };
+
+	char *buffers_ = nullptr;
+	std::size_t buffer_size_ = 0;
+	std::vector<status> status_;
+	std::deque<io_request> queue_;
+	std::vector<std::thread> threads_;
+	std::mutex mutex_;
+	std::condition_variable submitted_;
+	std::condition_variable completed_;
+	bool stop_ = false;
+
+	void work() {
+		std::unique_lock<std::mutex> lock(mutex_);
+		for(;;) {
+			submitted_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+			if(queue_.empty())
+				return;
+			io_request request = queue_.front();
+			queue_.pop_front();
+			lock.unlock();
+
+			char *buffer = buffers_ + request.buffer * buffer_size_;
+			bool ok = request.write
+				? helpers::pwrite_all(request.fd, buffer, request.size, request.offset)
+				: helpers::pread_all(request.fd, buffer, request.size, request.offset);
+
+			lock.lock();
+			status_[request.buffer] = ok ? status::done : status::failed;
+			completed_.notify_all();
+		}
+	}
+
+public:
+	thread_io_backend() noexcept = default;
+	thread_io_backend(const thread_io_backend &) = delete;
+	thread_io_backend &operator=(const thread_io_backend &) = delete;
+
+	~thread_io_backend() {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true; // the queued requests are still executed
+		}
+		submitted_.notify_all();
+		for(auto &thread : threads_)
+			thread.join();
+	}
+
+	bool init(char *buffers, std::size_t buffer_size, std::size_t num_buffers, std::size_t queue_depth) {
+		buffers_ = buffers;
+		buffer_size_ = buffer_size;
+		status_.assign(num_buffers, status::idle);
+		for(std::size_t i = 0; i < queue_depth; i++)
+			threads_.emplace_back([this] { work(); });
+		return true;
+	}
+
+	bool submit(const io_request &request) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			status_[request.buffer] = status::pending;
+			queue_.push_back(request);
+		}
+		submitted_.notify_one();
+		return true;
+	}
+
+	bool wait(std::size_t buffer) {
+		std::unique_lock<std::mutex> lock(mutex_);
+		completed_.wait(lock, [this, buffer] { return status_[buffer] != status::pending; });
+		bool ok = status_[buffer] != status::failed;
+		status_[buffer] = status::idle;
+		return ok;
+	}
+};
+
+namespace helpers {
+
+// the buffers are aligned (and padded) to pages, so they can also be used for direct I/O
+constexpr std::size_t async_io_alignment = 4096;
+
+struct async_io_free {
+	void operator()(char *ptr) const noexcept { ::operator delete(ptr, std::align_val_t(async_io_alignment)); }
+};
+
+inline char *async_io_alloc(std::size_t size) noexcept {
+	return static_cast<char *>(::operator new(size, std::align_val_t(async_io_alignment), std::nothrow));
+}
+
+} // namespace helpers
+
+/**
+ * @brief reads and writes the blocks of an array stored in a file asynchronously, overlapping the I/O with the processing of the blocks
+ *
+ * The file contains `num_blocks` blocks (the memory images of `BlockStruct`) one after another, i.e. the memory image of `structure()`,
+ * which is `BlockStruct` with an outer dimension `Dim` that selects the block. While a block is being processed, up to `queue_depth` other blocks are being read (or written).
+ *
+ * @tparam Dim: the dimension that selects the block
+ * @tparam BlockStruct: the structure of a block
+ * @tparam Backend: the I/O backend (see `thread_io_backend`)
+ */
+template<char Dim, class BlockStruct, class Backend = thread_io_backend>
+class async_block_file {
+	int fd_;
+	std::uint64_t file_offset_;
+	BlockStruct block_;
+	std::size_t num_blocks_;
+	std::size_t queue_depth_;
+	std::size_t block_size_;
+	std::size_t buffer_size_;
+	std::unique_ptr<char[], helpers::async_io_free> buffers_;
+	Backend backend_;
+	bool good_;
+
+	constexpr std::size_t num_buffers() const noexcept { return queue_depth_ + 1; }
+	char *buffer(std::size_t i) const noexcept { return buffers_.get() + i * buffer_size_; }
+	std::uint64_t block_offset(std::size_t block) const noexcept { return file_offset_ + std::uint64_t(block) * block_size_; }
+
+	bool submit(bool write, std::size_t block) {
+		return backend_.submit(io_request{fd_, write, block % num_buffers(), block_size_, block_offset(block)});
+	}
+
+	template<class F>
+	void process(F &f, std::size_t block) {
+		auto bag = make_bag(block_, buffer(block % num_buffers()));
+		f(idx<Dim>(block), bag);
+	}
+
+public:
+	/**
+	 * @param fd: a file descriptor open for reading and/or writing
+	 * @param file_offset: the position of the first block in the file
+	 * @param block: the structure of a block
+	 * @param num_blocks: the number of the blocks
+	 * @param queue_depth: how many blocks can be read or written at once (while another one is being processed)
+	 */
+	async_block_file(int fd, std::uint64_t file_offset, BlockStruct block, std::size_t num_blocks, std::size_t queue_depth = 4)
+		: fd_(fd), file_offset_(file_offset), block_(block), num_blocks_(num_blocks), queue_depth_(queue_depth > 0 ? queue_depth : 1),
+		  block_size_(block | get_size()),
+		  buffer_size_((block_size_ + helpers::async_io_alignment - 1) / helpers::async_io_alignment * helpers::async_io_alignment),
+		  buffers_(helpers::async_io_alloc((buffer_size_ > 0 ? buffer_size_ : helpers::async_io_alignment) * num_buffers())) {
+		good_ = buffers_ && backend_.init(buffers_.get(), buffer_size_, num_buffers(), queue_depth_);
+	}
+
+	async_block_file(const async_block_file &) = delete;
+	async_block_file &operator=(const async_block_file &) = delete;
+
+	bool good() const noexcept { return good_; }
+	const Backend &backend() const noexcept { return backend_; }
+
+	constexpr BlockStruct block_structure() const noexcept { return block_; }
+	constexpr std::size_t num_blocks() const noexcept { return num_blocks_; }
+
+	/**
+	 * @brief the structure of the whole array (as stored in the file)
+	 */
+	constexpr auto structure() const noexcept { return block_ ^ sized_vector<Dim>(num_blocks_); }
+
+	/**
+	 * @brief reads the blocks in order and calls `f(state, bag)` for each of them (the state has the index in `Dim`, the bag is valid only during the call)
+	 *
+	 * The next `queue_depth` blocks are being read while a block is being processed. Stops at the first block that cannot be read.
+	 *
+	 * @return whether all the blocks were read
+	 */
+	template<class F>
+	bool for_each_block(F f) {
+		if(!good_)
+			return false;
+		// the blocks in [waited, submitted) are being read
+		std::size_t submitted = 0, waited = 0;
+		bool ok = true;
+		for(; submitted < num_blocks_ && submitted < queue_depth_; submitted++)
+			if(!(ok = submit(false, submitted)))
+				break;
+		while(ok && waited < submitted) {
+			const std::size_t block = waited++;
+			if(!(ok = backend_.wait(block % num_buffers())))
+				break;
+			if(submitted < num_blocks_) {
+				if(!(ok = submit(false, submitted)))
+					break;
+				submitted++;
+			}
+			process(f, block);
+		}
+		// wait for the reads that are still in progress (their buffers must not be reused before)
+		for(; waited < submitted; waited++)
+			backend_.wait(waited % num_buffers());
+		return ok;
+	}
+
+	/**
+	 * @brief calls `f(state, bag)` to fill each block (in order) and writes the blocks
+	 *
+	 * Up to `queue_depth` blocks are being written while the next block is being filled.
+	 *
+	 * @return whether all the blocks were written
+	 */
+	template<class F>
+	bool write_blocks(F f) {
+		if(!good_)
+			return false;
+		// the blocks in [waited, submitted) are being written
+		std::size_t submitted = 0, waited = 0;
+		bool ok = true;
+		for(std::size_t block = 0; block < num_blocks_; block++) {
+			// the buffer of the block is free once the block `num_buffers()` before it is written
+			if(block >= num_buffers() && !backend_.wait(waited++ % num_buffers()))
+				ok = false;
+			process(f, block);
+			if(!submit(true, block)) {
+				ok = false;
+				break;
+			}
+			submitted++;
+		}
+		for(; waited < submitted; waited++)
+			if(!backend_.wait(waited % num_buffers()))
+				ok = false;
+		return ok;
+	}
+};
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_ASYNC_IO_HPP
@@ -217,6 +217,19 @@ constexpr auto make_bag(Structure s) noexcept {
 	return make_unique_bag(s);
 }
 
+/**
+ * @brief creates a bag with the given structure and allocates the underlying data block (implemented using std::unique_ptr) without initializing it
+ *
+ * Unlike `make_bag`, the memory is not zero-filled, so the pages are only mapped when they are first written
+ * (see also `tbb_make_bag` in tbb.hpp, which initializes the elements in parallel).
+ *
+ * @param s: the structure
+ */
+template<class Structure>
+constexpr auto make_uninitialized_bag(Structure s) noexcept {
+	return unique_bag<Structure>(s, std::unique_ptr<char[]>(new char[s | noarr::get_size()]));
+}
+
 /**
  * @brief creates a bag with the given structure and an underlying r/w observing data blob
  *
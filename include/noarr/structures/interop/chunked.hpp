@@ -0,0 +1,445 @@
+#ifndef NOARR_STRUCTURES_CHUNKED_HPP
+#define NOARR_STRUCTURES_CHUNKED_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../base/contain.hpp"
+#include "../base/utility.hpp"
+#include "../extra/funcs.hpp"
+#include "../extra/shortcuts.hpp"
+#include "../extra/struct_traits.hpp"
+#include "../extra/traverser.hpp"
+#include "../structs/scalar.hpp"
+#include "bag.hpp"
+#include "codec.hpp"
+#include "dynamic_struct.hpp"
+
+namespace noarr {
+
+/**
+ * @brief the position and the (encoded) size of a chunk in a chunked file
+ */
+struct chunk_entry {
+	std::uint64_t offset;
+	std::uint64_t size;
+};
+
+namespace helpers {
+
+template<class Dims, class ChunkDims>
+struct chunk_inner_dims;
+
+template<char... Dims, class ChunkDims>
+struct chunk_inner_dims<char_sequence<Dims...>, ChunkDims> {
+	using type = integer_sequence_concat<std::conditional_t<integer_sequence_contains<char, Dims, ChunkDims>, char_sequence<>, char_sequence<Dims>>...>;
+};
+
+// `Dims` are ordered from the outermost, the structure is built from the innermost
+template<class ValueType, class Struct, char... Dims, std::size_t... I>
+constexpr auto chunk_dense_struct(Struct s, char_sequence<Dims...>, std::index_sequence<I...>) noexcept {
+	constexpr std::size_t n = sizeof...(Dims);
+	constexpr char dims[] = {Dims..., '\0'};
+	return (scalar<ValueType>() ^ ... ^ sized_vector<dims[n - 1 - I]>(s | get_length<dims[n - 1 - I]>()));
+}
+
+} // namespace helpers
+
+/**
+ * @brief splits a structure to chunks (the sets of elements with the same indices in `ChunkDims`)
+ *
+ * The chunks are typically the blocks created by `into_blocks`, with `ChunkDims` being the major dimensions.
+ * All the chunks must have the same shape. A chunk is stored in a dense buffer, whose layout (`chunk_structure`) consists of the other
+ * dimensions of the structure (in the order of its signature). The chunks are numbered by the `grid`, a structure with the `ChunkDims`.
+ */
+template<class Struct, char... ChunkDims>
+struct chunk_layout_t : contain<Struct> {
+	using base = contain<Struct>;
+	using base::base;
+
+	using value_type = scalar_t<Struct>;
+	using chunk_dims = char_sequence<ChunkDims...>;
+	using inner_dims = typename helpers::chunk_inner_dims<typename helpers::dynamic_struct_dims<typename Struct::signature>::type, chunk_dims>::type;
+
+	static_assert(sizeof...(ChunkDims) > 0, "At least one chunk dimension must be given");
+	static_assert((... && Struct::signature::template any_accept<ChunkDims>), "The structure does not have all the chunk dimensions");
+
+	constexpr Struct structure() const noexcept { return base::template get<0>(); }
+
+	/**
+	 * @brief a structure of `chunk_entry` with the chunk dimensions (the first one is the outermost)
+	 */
+	constexpr auto grid() const noexcept {
+		return helpers::chunk_dense_struct<chunk_entry>(structure(), chunk_dims(), std::make_index_sequence<sizeof...(ChunkDims)>());
+	}
+
+	/**
+	 * @brief the dense layout of one chunk
+	 */
+	constexpr auto chunk_structure() const noexcept {
+		return helpers::chunk_dense_struct<value_type>(structure(), inner_dims(), std::make_index_sequence<inner_dims::size()>());
+	}
+
+	constexpr std::size_t chunk_size() const noexcept { return chunk_structure() | get_size(); }
+	constexpr std::size_t num_chunks() const noexcept { return (grid() | get_size()) / sizeof(chunk_entry); }
+
+	/**
+	 * @brief the number of the chunk containing the element (in the order of the `grid`)
+	 */
+	template<class State>
+	constexpr std::size_t chunk_number(State state) const noexcept {
+		return (grid() | offset(state)) / sizeof(chunk_entry);
+	}
+
+	/**
+	 * @brief copies the elements of a chunk from the data of the structure to a dense buffer
+	 */
+	template<class State>
+	void gather(const void *data, State chunk_state, void *chunk) const noexcept {
+		auto fixed = structure() ^ fix<ChunkDims...>(chunk_state);
+		auto dense = chunk_structure();
+		traverser(fixed).for_each([fixed, dense, data, chunk](auto state) {
+			dense | get_at(chunk, state) = fixed | get_at(data, state);
+		});
+	}
+
+	/**
+	 * @brief copies the elements of a chunk from a dense buffer to the data of the structure
+	 */
+	template<class State>
+	void scatter(const void *chunk, State chunk_state, void *data) const noexcept {
+		auto fixed = structure() ^ fix<ChunkDims...>(chunk_state);
+		auto dense = chunk_structure();
+		traverser(fixed).for_each([fixed, dense, data, chunk](auto state) {
+			fixed | get_at(data, state) = dense | get_at(chunk, state);
+		});
+	}
+};
+
+/**
+ * @brief splits a structure to chunks by the given dimensions, see `chunk_layout_t`
+ */
+template<char... ChunkDims, class Struct>
+constexpr auto chunk_layout(Struct s) noexcept { return chunk_layout_t<Struct, ChunkDims...>(s); }
+
+namespace helpers {
+
+// the file starts with the magic, the version, the codec name, the chunk size, the number of chunks, and the index (all in native byte order)
+constexpr char chunked_magic[8] = {'n', 'o', 'a', 'r', 'r', 'c', 'h', 'k'};
+constexpr std::uint32_t chunked_version = 1;
+constexpr std::size_t chunked_codec_name_size = 8;
+constexpr std::size_t chunked_header_size = sizeof(chunked_magic) + sizeof(std::uint32_t) + chunked_codec_name_size + 2 * sizeof(std::uint64_t);
+
+template<class Codec>
+void chunked_codec_name(char (&name)[chunked_codec_name_size]) noexcept {
+	static_assert(sizeof(Codec::name) <= chunked_codec_name_size + 1, "The codec name is too long");
+	std::memset(name, 0, chunked_codec_name_size);
+	std::memcpy(name, Codec::name, sizeof(Codec::name) - 1);
+}
+
+// a thread-safe least-recently-used cache of decoded chunks
+class chunk_lru_cache {
+	using chunk_ptr = std::shared_ptr<const std::vector<char>>;
+	using entry = std::pair<chunk_ptr, std::list<std::size_t>::iterator>;
+
+	std::size_t capacity_;
+	std::size_t hits_ = 0;
+	std::size_t misses_ = 0;
+	std::list<std::size_t> order_; // the most recently used first
+	std::unordered_map<std::size_t, entry> chunks_;
+	std::mutex mutex_;
+
+public:
+	explicit chunk_lru_cache(std::size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+	template<class Load>
+	chunk_ptr get(std::size_t key, const Load &load) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto it = chunks_.find(key);
+			if(it != chunks_.end()) {
+				hits_++;
+				order_.splice(order_.begin(), order_, it->second.second);
+				return it->second.first;
+			}
+			misses_++;
+		}
+
+		chunk_ptr chunk = load(); // outside the lock, so that more chunks can be decoded at once
+		if(!chunk)
+			return chunk;
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = chunks_.find(key);
+		if(it != chunks_.end()) // loaded by another thread in the meantime
+			return it->second.first;
+		order_.push_front(key);
+		chunks_.emplace(key, entry(chunk, order_.begin()));
+		while(chunks_.size() > capacity_) {
+			chunks_.erase(order_.back());
+			order_.pop_back();
+		}
+		return chunk;
+	}
+
+	std::size_t hits() noexcept { std::lock_guard<std::mutex> lock(mutex_); return hits_; }
+	std::size_t misses() noexcept { std::lock_guard<std::mutex> lock(mutex_); return misses_; }
+};
+
+} // namespace helpers
+
+/**
+ * @brief compresses the chunks of a structure and writes them to a stream
+ *
+ * The chunks are encoded independently by `encode`, which may be called from multiple threads at once (for different chunks),
+ * e.g. from a traversal of the `grid` of the layout. `write` then writes the header, the index, and the encoded chunks.
+ */
+template<class Layout, class Codec = lz4_codec>
+class chunked_encoder {
+	Layout layout_;
+	Codec codec_;
+	std::vector<std::vector<char>> chunks_;
+
+public:
+	explicit chunked_encoder(Layout layout, Codec codec = Codec()) : layout_(layout), codec_(codec), chunks_(layout.num_chunks()) {}
+
+	const Layout &layout() const noexcept { return layout_; }
+
+	/**
+	 * @brief encodes one chunk of `data` (the chunk is selected by the indices in the chunk dimensions, other indices are ignored)
+	 */
+	template<class State>
+	void encode(State chunk_state, const void *data) {
+		std::vector<char> chunk(layout_.chunk_size());
+		layout_.gather(data, chunk_state, chunk.data());
+
+		std::vector<char> &encoded = chunks_[layout_.chunk_number(chunk_state)];
+		encoded.resize(codec_.max_encoded_size(chunk.size()));
+		encoded.resize(codec_.encode(chunk.data(), chunk.size(), encoded.data()));
+		encoded.shrink_to_fit();
+	}
+
+	/**
+	 * @brief encodes all the chunks of `data` (sequentially)
+	 */
+	void encode_all(const void *data) {
+		traverser(layout_.grid()).for_each([this, data](auto chunk_state) { encode(chunk_state, data); });
+	}
+
+	/**
+	 * @brief writes the encoded chunks (all of them must have been encoded)
+	 *
+	 * @return whether the stream is still good
+	 */
+	bool write(std::ostream &out) const {
+		char codec_name[helpers::chunked_codec_name_size];
+		helpers::chunked_codec_name<Codec>(codec_name);
+		std::uint64_t chunk_size = layout_.chunk_size();
+		std::uint64_t num_chunks = chunks_.size();
+
+		out.write(helpers::chunked_magic, sizeof(helpers::chunked_magic));
+		out.write(reinterpret_cast<const char *>(&helpers::chunked_version), sizeof(helpers::chunked_version));
+		out.write(codec_name, sizeof(codec_name));
+		out.write(reinterpret_cast<const char *>(&chunk_size), sizeof(chunk_size));
+		out.write(reinterpret_cast<const char *>(&num_chunks), sizeof(num_chunks));
+
+		std::uint64_t offset = helpers::chunked_header_size + num_chunks * sizeof(chunk_entry);
+		for(const auto &chunk : chunks_) {
+			chunk_entry entry{offset, chunk.size()};
+			out.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+			offset += chunk.size();
+		}
+		for(const auto &chunk : chunks_)
+			out.write(chunk.data(), std::streamsize(chunk.size()));
+		return bool(out);
+	}
+};
+
+/**
+ * @brief encodes all the chunks of a structure and writes them to a stream
+ *
+ * @return whether the stream is still good
+ */
+template<class Codec = lz4_codec, class Layout>
+bool write_chunked(std::ostream &out, Layout layout, const void *data, Codec codec = Codec()) {
+	chunked_encoder<Layout, Codec> encoder(layout, codec);
+	encoder.encode_all(data);
+	return encoder.write(out);
+}
+
+/**
+ * @brief reads the index of a chunked stream and decodes its chunks
+ *
+ * The header must match the layout and the codec. The stream must stay open (and seekable) while the reader is used.
+ * The chunks may be decoded from multiple threads at once: the stream is accessed under a lock, the decoding itself is parallel.
+ */
+template<class Layout, class Codec = lz4_codec>
+class chunked_reader {
+	Layout layout_;
+	Codec codec_;
+	std::istream *in_;
+	std::vector<chunk_entry> index_;
+	mutable std::mutex mutex_;
+
+public:
+	chunked_reader(Layout layout, std::istream &in, Codec codec = Codec()) : layout_(layout), codec_(codec), in_(&in) {
+		char magic[sizeof(helpers::chunked_magic)];
+		std::uint32_t version;
+		char codec_name[helpers::chunked_codec_name_size], expected_codec_name[helpers::chunked_codec_name_size];
+		std::uint64_t chunk_size, num_chunks;
+		helpers::chunked_codec_name<Codec>(expected_codec_name);
+
+		in.read(magic, sizeof(magic));
+		in.read(reinterpret_cast<char *>(&version), sizeof(version));
+		in.read(codec_name, sizeof(codec_name));
+		in.read(reinterpret_cast<char *>(&chunk_size), sizeof(chunk_size));
+		in.read(reinterpret_cast<char *>(&num_chunks), sizeof(num_chunks));
+		if(!in || std::memcmp(magic, helpers::chunked_magic, sizeof(magic)) != 0 || version != helpers::chunked_version
+			|| std::memcmp(codec_name, expected_codec_name, sizeof(codec_name)) != 0
+			|| chunk_size != layout.chunk_size() || num_chunks != layout.num_chunks())
+			return;
+
+		std::vector<chunk_entry> index(num_chunks);
+		in.read(reinterpret_cast<char *>(index.data()), std::streamsize(num_chunks * sizeof(chunk_entry)));
+		if(in)
+			index_ = std::move(index);
+	}
+
+	/**
+	 * @brief whether the header and the index have been read successfully
+	 */
+	bool good() const noexcept { return index_.size() == layout_.num_chunks(); }
+
+	const Layout &layout() const noexcept { return layout_; }
+
+	/**
+	 * @brief the index of the chunks, a bag with the `grid` structure of the layout
+	 */
+	auto index() const noexcept { return make_bag(layout_.grid(), static_cast<const void *>(index_.data())); }
+
+	/**
+	 * @brief reads and decodes a chunk (given by its number) to a buffer of `layout().chunk_size()` bytes
+	 *
+	 * @return whether the chunk has been decoded successfully
+	 */
+	bool read_chunk(std::size_t number, char *chunk) const {
+		if(number >= index_.size())
+			return false;
+		const chunk_entry &entry = index_[number];
+		// a corrupted index must not make us allocate more than any encoded chunk can take
+		if(entry.size > codec_.max_encoded_size(layout_.chunk_size()))
+			return false;
+		std::vector<char> encoded(entry.size);
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			in_->clear();
+			in_->seekg(std::streamoff(entry.offset));
+			in_->read(encoded.data(), std::streamsize(entry.size));
+			if(!*in_)
+				return false;
+		}
+		return codec_.decode(encoded.data(), encoded.size(), chunk, layout_.chunk_size());
+	}
+
+	/**
+	 * @brief decodes one chunk to the data of the structure (the chunk is selected by the indices in the chunk dimensions)
+	 *
+	 * @return whether the chunk has been decoded successfully
+	 */
+	template<class State>
+	bool decode(State chunk_state, void *data) const {
+		std::vector<char> chunk(layout_.chunk_size());
+		if(!read_chunk(layout_.chunk_number(chunk_state), chunk.data()))
+			return false;
+		layout_.scatter(chunk.data(), chunk_state, data);
+		return true;
+	}
+
+	/**
+	 * @brief decodes all the chunks to the data of the structure (sequentially)
+	 *
+	 * @return whether all the chunks have been decoded successfully
+	 */
+	bool decode_all(void *data) const {
+		bool ok = good();
+		traverser(layout_.grid()).for_each([this, data, &ok](auto chunk_state) { ok = decode(chunk_state, data) && ok; });
+		return ok;
+	}
+};
+
+/**
+ * @brief a read-only bag-like view of a chunked stream, which decodes the chunks on demand
+ *
+ * The decoded chunks are kept in a least-recently-used cache of the given capacity (in chunks). The view can be used from multiple threads at once.
+ * Accessing each element through the cache is relatively expensive, so traversals should preferably work chunk by chunk (see `chunk`).
+ */
+template<class Layout, class Codec = lz4_codec>
+class chunked_bag {
+	const chunked_reader<Layout, Codec> *reader_;
+	mutable helpers::chunk_lru_cache cache_;
+
+	using value_type = typename Layout::value_type;
+
+	auto load(std::size_t number) const {
+		return cache_.get(number, [this, number] {
+			auto chunk = std::make_shared<std::vector<char>>(reader_->layout().chunk_size());
+			std::shared_ptr<const std::vector<char>> result;
+			if(reader_->read_chunk(number, chunk->data()))
+				result = std::move(chunk);
+			return result;
+		});
+	}
+
+public:
+	chunked_bag(const chunked_reader<Layout, Codec> &reader, std::size_t cache_capacity) : reader_(&reader), cache_(cache_capacity) {}
+
+	constexpr auto structure() const noexcept { return reader_->layout().structure(); }
+
+	template<char Dim>
+	constexpr auto get_length() const noexcept { return structure() | noarr::get_length<Dim>(); }
+
+	/**
+	 * @brief reads an element (a value-initialized value is returned if its chunk cannot be decoded)
+	 */
+	template<class State>
+	value_type operator[](State state) const {
+		auto chunk = load(reader_->layout().chunk_number(state));
+		if(!chunk)
+			return value_type();
+		return reader_->layout().chunk_structure() | get_at(static_cast<const void *>(chunk->data()), state);
+	}
+
+	template<char... Dims, class... Ts>
+	value_type at(Ts... ts) const {
+		return (*this)[idx<Dims...>(ts...)];
+	}
+
+	/**
+	 * @brief returns the decoded chunk containing the element (the other dimensions of the state are ignored)
+	 *
+	 * The result is a pair of a bag with the `chunk_structure` of the layout and a pointer keeping the chunk alive
+	 * (the bag is null if the chunk cannot be decoded).
+	 */
+	template<class State>
+	auto chunk(State state) const {
+		auto chunk = load(reader_->layout().chunk_number(state));
+		const void *data = chunk ? chunk->data() : nullptr;
+		return std::make_pair(make_bag(reader_->layout().chunk_structure(), data), std::move(chunk));
+	}
+
+	std::size_t cache_hits() const noexcept { return cache_.hits(); }
+	std::size_t cache_misses() const noexcept { return cache_.misses(); }
+};
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_CHUNKED_HPP
@@ -0,0 +1,265 @@
+#ifndef NOARR_STRUCTURES_CODEC_HPP
+#define NOARR_STRUCTURES_CODEC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../extra/shortcuts.hpp"
+#include "../extra/shuffle.hpp"
+#include "../structs/scalar.hpp"
+
+namespace noarr {
+
+// A codec compresses independent blocks of bytes (e.g. the chunks of a chunked array). It has the following interface:
+//
+// struct codec {
+// 	static constexpr char name[] = "...";                                       // identifies the format (at most 8 characters)
+// 	std::size_t max_encoded_size(std::size_t size) const noexcept;              // an upper bound of the encoded size
+// 	std::size_t encode(const char *src, std::size_t size, char *dst) const;     // `dst` has `max_encoded_size(size)` bytes, returns the encoded size
+// 	bool decode(const char *src, std::size_t encoded_size, char *dst, std::size_t size) const noexcept; // fails on corrupt input
+// };
+//
+// The codecs must be usable from multiple threads at once.
+
+/**
+ * @brief stores the bytes as they are
+ */
+struct raw_codec {
+	static constexpr char name[] = "raw";
+
+	std::size_t max_encoded_size(std::size_t size) const noexcept { return size; }
+
+	std::size_t encode(const char *src, std::size_t size, char *dst) const noexcept {
+		std::memcpy(dst, src, size);
+		return size;
+	}
+
+	bool decode(const char *src, std::size_t encoded_size, char *dst, std::size_t size) const noexcept {
+		if(encoded_size != size)
+			return false;
+		std::memcpy(dst, src, size);
+		return true;
+	}
+};
+
+/**
+ * @brief a fast LZ77 compressor producing the LZ4 block format
+ *
+ * The encoder is a greedy single-pass matcher with a hash table of recent positions (it favors speed over ratio, like LZ4's default mode).
+ * The decoder checks all the lengths and offsets, so a corrupt block is rejected instead of reading or writing out of bounds.
+ */
+struct lz4_codec {
+	static constexpr char name[] = "lz4";
+
+	std::size_t max_encoded_size(std::size_t size) const noexcept { return size + size / 255 + 16; }
+
+	std::size_t encode(const char *src, std::size_t size, char *dst) const {
+		const auto *in = reinterpret_cast<const unsigned char *>(src);
+		auto *out = reinterpret_cast<unsigned char *>(dst);
+		std::size_t op = 0;
+		std::size_t anchor = 0;
+
+		if(size >= min_input) {
+			std::vector<std::uint32_t> table(std::size_t(1) << hash_bits); // positions + 1, zero is empty
+			const std::size_t match_limit = size - last_literals;
+			for(std::size_t ip = 0; ip + min_input <= size;) {
+				std::uint32_t seq = read32(in + ip);
+				std::uint32_t &slot = table[hash(seq)];
+				std::size_t ref = slot;
+				slot = std::uint32_t(ip + 1);
+				if(ref == 0 || ip - (ref - 1) > max_offset || read32(in + ref - 1) != seq) {
+					ip++;
+					continue;
+				}
+				ref--;
+
+				std::size_t length = min_match;
+				while(ip + length < match_limit && in[ref + length] == in[ip + length])
+					length++;
+
+				op = write_sequence(out, op, in + anchor, ip - anchor, length - min_match);
+				out[op++] = (unsigned char)(ip - ref);
+				out[op++] = (unsigned char)((ip - ref) >> 8);
+				op = write_length(out, op, length - min_match);
+
+				ip += length;
+				anchor = ip;
+			}
+		}
+
+		return write_sequence(out, op, in + anchor, size - anchor, 0);
+	}
+
+	bool decode(const char *src, std::size_t encoded_size, char *dst, std::size_t size) const noexcept {
+		const auto *in = reinterpret_cast<const unsigned char *>(src);
+		auto *out = reinterpret_cast<unsigned char *>(dst);
+		std::size_t ip = 0;
+		std::size_t op = 0;
+
+		while(ip < encoded_size) {
+			unsigned token = in[ip++];
+
+			std::size_t literals = token >> 4;
+			if(!read_length(in, encoded_size, ip, literals))
+				return false;
+			if(encoded_size - ip < literals || size - op < literals)
+				return false;
+			std::memcpy(out + op, in + ip, literals);
+			ip += literals;
+			op += literals;
+
+			if(ip == encoded_size)
+				return op == size; // the last sequence has no match
+
+			if(encoded_size - ip < 2)
+				return false;
+			std::size_t offset = in[ip] | std::size_t(in[ip + 1]) << 8;
+			ip += 2;
+			if(offset == 0 || offset > op)
+				return false;
+
+			std::size_t length = token & 15;
+			if(!read_length(in, encoded_size, ip, length))
+				return false;
+			length += min_match;
+			if(size - op < length)
+				return false;
+			for(std::size_t i = 0; i < length; i++, op++) // the source may overlap the destination
+				out[op] = out[op - offset];
+		}
+
+		return false;
+	}
+
+private:
+	static constexpr std::size_t min_match = 4;
+	static constexpr std::size_t last_literals = 5;
+	static constexpr std::size_t min_input = 13; // the last match must start at least 12 bytes before the end
+	static constexpr std::size_t max_offset = 65535;
+	static constexpr unsigned hash_bits = 12;
+
+	static std::uint32_t read32(const unsigned char *p) noexcept {
+		std::uint32_t v;
+		std::memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	static std::size_t hash(std::uint32_t seq) noexcept {
+		return (seq * 2654435761u) >> (32 - hash_bits);
+	}
+
+	static std::size_t write_length(unsigned char *out, std::size_t op, std::size_t length) noexcept {
+		if(length < 15)
+			return op;
+		for(length -= 15; length >= 255; length -= 255)
+			out[op++] = 255;
+		out[op++] = (unsigned char)length;
+		return op;
+	}
+
+	static std::size_t write_sequence(unsigned char *out, std::size_t op, const unsigned char *literals, std::size_t num_literals, std::size_t match_length) noexcept {
+		out[op++] = (unsigned char)((num_literals < 15 ? num_literals : 15) << 4 | (match_length < 15 ? match_length : 15));
+		op = write_length(out, op, num_literals);
+		std::memcpy(out + op, literals, num_literals);
+		return op + num_literals;
+	}
+
+	static bool read_length(const unsigned char *in, std::size_t encoded_size, std::size_t &ip, std::size_t &length) noexcept {
+		if(length != 15)
+			return true;
+		unsigned char byte;
+		do {
+			if(ip == encoded_size)
+				return false;
+			byte = in[ip++];
+			length += byte;
+		} while(byte == 255);
+		return true;
+	}
+};
+
+namespace helpers {
+
+template<std::size_t Size>
+struct codec_name {
+	char chars[Size];
+};
+
+// e.g. "b4lz4" for 4-byte elements and `lz4_codec`, "b8dlz4" with delta encoding
+template<std::size_t ElemSize, bool Delta, class Codec>
+constexpr auto make_shuffle_codec_name() noexcept {
+	static_assert(ElemSize > 0 && ElemSize < 100, "Unsupported element size");
+	codec_name<2 + (ElemSize >= 10) + Delta + sizeof(Codec::name)> name{};
+	std::size_t i = 0;
+	name.chars[i++] = 'b';
+	if(ElemSize >= 10)
+		name.chars[i++] = char('0' + ElemSize / 10);
+	name.chars[i++] = char('0' + ElemSize % 10);
+	if(Delta)
+		name.chars[i++] = 'd';
+	for(std::size_t j = 0; j < sizeof(Codec::name); j++)
+		name.chars[i++] = Codec::name[j];
+	return name;
+}
+
+template<std::size_t ElemSize, bool Delta, class Codec>
+inline constexpr auto shuffle_codec_name = make_shuffle_codec_name<ElemSize, Delta, Codec>();
+
+} // namespace helpers
+
+/**
+ * @brief byte-shuffles (and optionally delta-encodes) the elements of a block before compressing it with another codec
+ *
+ * The `k`-th bytes of all the elements are stored together (see `byte_shuffle`), with `Delta`, each byte is replaced by its difference from the same byte of the previous element
+ * (see `delta_encode`). This makes numerical data (especially floating-point) much more compressible. The bytes after the last whole element are not shuffled.
+ *
+ * @tparam ElemSize: the size of the elements
+ * @tparam Codec: the codec that compresses the shuffled bytes
+ * @tparam Delta: whether the shuffled bytes are delta-encoded
+ */
+template<std::size_t ElemSize, class Codec = lz4_codec, bool Delta = false>
+struct shuffle_codec {
+	static constexpr const auto &name = helpers::shuffle_codec_name<ElemSize, Delta, Codec>.chars;
+
+	Codec codec;
+
+	std::size_t max_encoded_size(std::size_t size) const noexcept { return codec.max_encoded_size(size); }
+
+	std::size_t encode(const char *src, std::size_t size, char *dst) const {
+		std::vector<char> shuffled(size);
+		const std::size_t n = size / ElemSize;
+		byte_shuffle(elements(n), src, shuffled.data());
+		std::memcpy(shuffled.data() + n * ElemSize, src + n * ElemSize, size - n * ElemSize);
+		if constexpr(Delta)
+			delta_encode<'i'>(planes(n), shuffled.data());
+		return codec.encode(shuffled.data(), size, dst);
+	}
+
+	bool decode(const char *src, std::size_t encoded_size, char *dst, std::size_t size) const {
+		std::vector<char> shuffled(size);
+		if(!codec.decode(src, encoded_size, shuffled.data(), size))
+			return false;
+		const std::size_t n = size / ElemSize;
+		if constexpr(Delta)
+			delta_decode<'i'>(planes(n), shuffled.data());
+		byte_unshuffle(elements(n), shuffled.data(), dst);
+		std::memcpy(dst + n * ElemSize, shuffled.data() + n * ElemSize, size - n * ElemSize);
+		return true;
+	}
+
+private:
+	static constexpr auto elements(std::size_t n) noexcept {
+		return scalar<std::array<unsigned char, ElemSize>>() ^ sized_vector<'i'>(n);
+	}
+
+	static constexpr auto planes(std::size_t n) noexcept {
+		return scalar<unsigned char>() ^ sized_vector<'i'>(n) ^ sized_vector<'b'>(ElemSize);
+	}
+};
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_CODEC_HPP
@@ -0,0 +1,319 @@
+#ifndef NOARR_STRUCTURES_DLPACK_HPP
+#define NOARR_STRUCTURES_DLPACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../base/utility.hpp"
+#include "../extra/funcs.hpp"
+#include "../extra/shortcuts.hpp"
+#include "../extra/struct_traits.hpp"
+#include "../structs/scalar.hpp"
+#include "../structs/slice.hpp"
+#include "bag.hpp"
+#include "dynamic_struct.hpp"
+
+namespace noarr {
+
+// The following types have the same layout as `DLDevice`, `DLDataType`, `DLTensor`, and `DLManagedTensor` from `dlpack.h` (version 0.8),
+// so they can be passed to and received from the libraries that use DLPack (by a `reinterpret_cast`) without depending on the header.
+
+enum dl_device_type : std::int32_t {
+	dl_cpu = 1,
+	dl_cuda = 2,
+	dl_cuda_host = 3,
+	dl_cuda_managed = 13,
+};
+
+enum dl_data_type_code : std::uint8_t {
+	dl_int = 0,
+	dl_uint = 1,
+	dl_float = 2,
+	dl_bool = 6,
+};
+
+struct dl_device {
+	std::int32_t device_type;
+	std::int32_t device_id;
+};
+
+struct dl_data_type {
+	std::uint8_t code;
+	std::uint8_t bits;
+	std::uint16_t lanes;
+};
+
+struct dl_tensor {
+	void *data;
+	dl_device device;
+	std::int32_t ndim;
+	dl_data_type dtype;
+	std::int64_t *shape;
+	std::int64_t *strides; // in elements, `nullptr` means a compact row-major tensor
+	std::uint64_t byte_offset;
+};
+
+struct dl_managed_tensor {
+	dl_tensor tensor;
+	void *manager_ctx;
+	void (*deleter)(dl_managed_tensor *self);
+};
+
+/**
+ * @brief the DLPack data type describing the `ValueType` (which must be an arithmetic type)
+ */
+template<class ValueType>
+constexpr dl_data_type dl_data_type_of() noexcept {
+	static_assert(std::is_arithmetic_v<ValueType>, "DLPack can only describe tensors of arithmetic types");
+	std::uint8_t code = dl_uint;
+	if constexpr(std::is_same_v<ValueType, bool>)
+		code = dl_bool;
+	else if constexpr(std::is_floating_point_v<ValueType>)
+		code = dl_float;
+	else if constexpr(std::is_signed_v<ValueType>)
+		code = dl_int;
+	return dl_data_type{code, std::uint8_t(sizeof(ValueType) * 8), 1};
+}
+
+/**
+ * @brief a `dl_tensor` describing a noarr structure, along with the shape and strides it points to
+ *
+ * The data are not owned, they must outlive all the uses of the descriptor. The object can be moved (the descriptor stays valid),
+ * but not copied. To pass the descriptor to a library that takes ownership of a `DLManagedTensor`, use `release`.
+ */
+class dlpack_tensor {
+	std::vector<std::int64_t> shape_;
+	std::vector<std::int64_t> strides_;
+	dl_managed_tensor managed_;
+
+public:
+	dlpack_tensor(void *data, dl_device device, dl_data_type dtype, std::vector<std::int64_t> shape, std::vector<std::int64_t> strides, std::uint64_t byte_offset)
+		: shape_(std::move(shape)), strides_(std::move(strides)),
+		  managed_{dl_tensor{data, device, std::int32_t(shape_.size()), dtype, shape_.data(), strides_.data(), byte_offset}, nullptr, nullptr} {}
+
+	dlpack_tensor(const dlpack_tensor &) = delete;
+	dlpack_tensor &operator=(const dlpack_tensor &) = delete;
+	dlpack_tensor(dlpack_tensor &&) noexcept = default;
+	dlpack_tensor &operator=(dlpack_tensor &&) noexcept = default;
+
+	const dl_tensor &tensor() const noexcept { return managed_.tensor; }
+
+	/**
+	 * @brief moves the descriptor to a newly allocated `dl_managed_tensor`, whose deleter frees it (but not the data)
+	 */
+	dl_managed_tensor *release() && {
+		auto *owner = new dlpack_tensor(std::move(*this));
+		owner->managed_.manager_ctx = owner;
+		owner->managed_.deleter = [](dl_managed_tensor *self) { delete static_cast<dlpack_tensor *>(self->manager_ctx); };
+		return &owner->managed_;
+	}
+};
+
+namespace helpers {
+
+// how one axis of an imported tensor is composed: `sized_vector(vector_length) ^ step(0, step) ^ slice(0, length)`, possibly reversed
+struct dlpack_axis {
+	std::size_t length;
+	std::size_t vector_length;
+	std::size_t step;
+	bool reversed;
+};
+
+// the smallest divisor of `n` that is at least `min`, or zero if there is none
+inline std::size_t dlpack_divisor_at_least(std::size_t n, std::size_t min) noexcept {
+	std::size_t best = 0;
+	for(std::size_t d = 1; d * d <= n; d++) {
+		if(n % d != 0)
+			continue;
+		if(d >= min && (best == 0 || d < best))
+			best = d;
+		if(n / d >= min && (best == 0 || n / d < best))
+			best = n / d;
+	}
+	return best;
+}
+
+inline std::size_t dlpack_gcd(std::size_t a, std::size_t b) noexcept {
+	while(b != 0)
+		a = std::exchange(b, a % b);
+	return a;
+}
+
+// plans the axes from the innermost one (the last one), each one being nested in a vector whose stride divides the strides of the outer axes;
+// `shift` is the offset (in elements) of the first element of the resulting structure relative to the first element of the tensor
+inline bool dlpack_plan(const dl_tensor &t, dlpack_axis *axes, std::ptrdiff_t &shift) noexcept {
+	const std::size_t n = std::size_t(t.ndim);
+	std::vector<std::size_t> strides(n);
+	bool empty = false;
+	std::size_t compact = 1;
+	for(std::size_t k = n; k-- > 0;) {
+		if(t.shape[k] < 0)
+			return false;
+		if(t.strides && t.strides[k] < 0)
+			axes[k].reversed = t.shape[k] > 1;
+		else
+			axes[k].reversed = false;
+		strides[k] = t.strides ? std::size_t(t.strides[k] < 0 ? -t.strides[k] : t.strides[k]) : compact;
+		axes[k].length = std::size_t(t.shape[k]);
+		axes[k].vector_length = axes[k].length;
+		axes[k].step = 1;
+		empty = empty || axes[k].length == 0;
+		compact *= axes[k].length;
+	}
+
+	shift = 0;
+	if(empty) {
+		for(std::size_t k = 0; k < n; k++)
+			axes[k].reversed = false;
+		return true;
+	}
+
+	std::size_t inner = 1;
+	for(std::size_t k = n; k-- > 0;) {
+		dlpack_axis &axis = axes[k];
+		if(axis.length == 1)
+			continue;
+		if(strides[k] == 0 || strides[k] % inner != 0)
+			return false;
+		axis.step = strides[k] / inner;
+
+		std::size_t outer = 0;
+		for(std::size_t j = 0; j < k; j++)
+			if(axes[j].length > 1)
+				outer = dlpack_gcd(outer, strides[j]);
+
+		std::size_t needed = (axis.length - 1) * axis.step + 1;
+		if(outer == 0) {
+			axis.vector_length = needed;
+		} else {
+			if(outer % inner != 0)
+				return false;
+			axis.vector_length = dlpack_divisor_at_least(outer / inner, needed);
+			if(axis.vector_length == 0)
+				return false;
+		}
+		inner *= axis.vector_length;
+
+		if(axis.reversed)
+			shift -= std::ptrdiff_t((axis.length - 1) * strides[k]);
+	}
+	return true;
+}
+
+template<char Dim>
+constexpr auto dlpack_axis_proto(const dlpack_axis &axis) noexcept {
+	return sized_vector<Dim>(axis.vector_length) ^ step<Dim>(std::size_t(0), axis.step) ^ slice<Dim>(std::size_t(0), axis.length);
+}
+
+// `Dims` are ordered from the outermost, the structure is built from the innermost
+template<class ValueType, char... Dims, std::size_t... I>
+auto dlpack_to_struct(const dlpack_axis *axes, std::index_sequence<I...>) noexcept {
+	constexpr std::size_t n = sizeof...(Dims);
+	constexpr char dims[] = {Dims..., '\0'};
+	return (scalar<ValueType>() ^ ... ^ dlpack_axis_proto<dims[n - 1 - I]>(axes[n - 1 - I]));
+}
+
+template<class ValueType, char... Dims>
+bool dlpack_check(const dl_tensor &t) noexcept {
+	constexpr dl_data_type dtype = dl_data_type_of<ValueType>();
+	return t.ndim == std::int32_t(sizeof...(Dims)) && t.dtype.code == dtype.code && t.dtype.bits == dtype.bits && t.dtype.lanes == dtype.lanes;
+}
+
+template<class ValueType>
+void *dlpack_base(const dl_tensor &t, std::ptrdiff_t shift) noexcept {
+	return static_cast<char *>(t.data) + t.byte_offset + shift * std::ptrdiff_t(sizeof(ValueType));
+}
+
+template<class Struct, char... Reversed, class F>
+void dlpack_dispatch_reversed(Struct s, void *data, const dlpack_axis *, char_sequence<>, char_sequence<Reversed...>, F &f) {
+	f(make_bag(s ^ reverse<Reversed...>(), data));
+}
+
+template<class Struct, char Dim, char... Dims, char... Reversed, class F>
+void dlpack_dispatch_reversed(Struct s, void *data, const dlpack_axis *axes, char_sequence<Dim, Dims...>, char_sequence<Reversed...>, F &f) {
+	if(axes[0].reversed)
+		dlpack_dispatch_reversed(s, data, axes + 1, char_sequence<Dims...>(), char_sequence<Reversed..., Dim>(), f);
+	else
+		dlpack_dispatch_reversed(s, data, axes + 1, char_sequence<Dims...>(), char_sequence<Reversed...>(), f);
+}
+
+} // namespace helpers
+
+/**
+ * @brief describes a structure and a pointer to its data as a DLPack tensor, without copying the data
+ *
+ * The axes of the tensor are the dimensions of the structure, ordered as in its signature (from the outermost one).
+ * The structure cannot contain tuples (this is checked statically) and its scalar must be an arithmetic type.
+ * It must be affine (each index contributes to the offset by a constant stride, a multiple of the element size):
+ * this holds e.g. for vectors, slices, steps, reverses, fixes, renames, and broadcasts, but not for `merge_zcurve` or (in general) `merge_blocks`.
+ * The strides are checked along each dimension, without iterating over the whole structure.
+ *
+ * @return the descriptor, or nothing if the structure is not affine
+ */
+template<class Struct>
+std::optional<dlpack_tensor> to_dlpack(Struct s, void *data, dl_device device = dl_device{dl_cpu, 0}) {
+	using value_type = scalar_t<Struct>;
+	constexpr dl_data_type dtype = dl_data_type_of<value_type>();
+
+	std::optional<dynamic_struct> ds = to_dynamic_struct(s);
+	if(!ds)
+		return std::nullopt;
+
+	std::vector<std::int64_t> shape, strides;
+	for(const auto &dim : ds->dims()) {
+		if(dim.stride % std::ptrdiff_t(sizeof(value_type)) != 0)
+			return std::nullopt;
+		shape.push_back(std::int64_t(dim.length));
+		strides.push_back(std::int64_t(dim.stride / std::ptrdiff_t(sizeof(value_type))));
+	}
+
+	return dlpack_tensor(data, device, dtype, std::move(shape), std::move(strides), ds->offset());
+}
+
+/**
+ * @brief views a DLPack tensor of non-negative strides as a bag, without copying the data
+ *
+ * The `Dims` name the axes of the tensor, from the first (outermost) one. Each axis is composed of a `sized_vector`, a `step`, and a `slice`,
+ * so the axes must be ordered by decreasing strides (e.g. a C-contiguous array or a slice of one, possibly with steps).
+ *
+ * @return the bag, or nothing if the rank or the data type differ, or the strides cannot be expressed so (e.g. they are negative, zero, or overlapping)
+ */
+template<class ValueType, char... Dims>
+auto from_dlpack(const dl_tensor &t) noexcept {
+	helpers::dlpack_axis axes[sizeof...(Dims) + 1] = {};
+	using bag_t = decltype(make_bag(helpers::dlpack_to_struct<ValueType, Dims...>(axes, std::make_index_sequence<sizeof...(Dims)>()), (void *)nullptr));
+
+	std::ptrdiff_t shift;
+	if(!helpers::dlpack_check<ValueType, Dims...>(t) || !helpers::dlpack_plan(t, axes, shift))
+		return std::optional<bag_t>();
+	for(std::size_t k = 0; k < sizeof...(Dims); k++)
+		if(axes[k].reversed)
+			return std::optional<bag_t>();
+	return std::optional<bag_t>(make_bag(helpers::dlpack_to_struct<ValueType, Dims...>(axes, std::make_index_sequence<sizeof...(Dims)>()), helpers::dlpack_base<ValueType>(t, shift)));
+}
+
+/**
+ * @brief like `from_dlpack`, but also supports negative strides (the axes with negative strides are reversed using `reverse`)
+ *
+ * The bag is passed to `f`, which is instantiated for each combination of reversed axes.
+ *
+ * @return whether the tensor could be expressed (and `f` was called)
+ */
+template<class ValueType, char... Dims, class F>
+bool with_dlpack(const dl_tensor &t, F f) {
+	helpers::dlpack_axis axes[sizeof...(Dims) + 1] = {};
+	std::ptrdiff_t shift;
+	if(!helpers::dlpack_check<ValueType, Dims...>(t) || !helpers::dlpack_plan(t, axes, shift))
+		return false;
+	auto s = helpers::dlpack_to_struct<ValueType, Dims...>(axes, std::make_index_sequence<sizeof...(Dims)>());
+	helpers::dlpack_dispatch_reversed(s, helpers::dlpack_base<ValueType>(t, shift), axes, char_sequence<Dims...>(), char_sequence<>(), f);
+	return true;
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_DLPACK_HPP
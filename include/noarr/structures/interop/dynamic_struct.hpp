@@ -0,0 +1,240 @@
+#ifndef NOARR_STRUCTURES_DYNAMIC_STRUCT_HPP
+#define NOARR_STRUCTURES_DYNAMIC_STRUCT_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../base/utility.hpp"
+#include "../extra/funcs.hpp"
+#include "../extra/shortcuts.hpp"
+#include "../extra/struct_traits.hpp"
+#include "../structs/scalar.hpp"
+
+namespace noarr {
+
+/**
+ * @brief one dimension of a `dynamic_struct`
+ */
+struct dynamic_dim {
+	char name;
+	std::size_t length;
+	std::ptrdiff_t stride; // in bytes
+};
+
+/**
+ * @brief a type-erased affine layout: the rank, the dimension names, the lengths and the strides are only known at runtime
+ *
+ * The dimensions are ordered from the outermost one (as in a C array declaration). The offset of an element is
+ * `offset() + sum(index[d] * stride[d])`. It is meant for the boundaries of a program (e.g. layouts read from a file),
+ * the computations should use the static structures obtained through `with_static`.
+ */
+class dynamic_struct {
+	std::size_t elem_size_;
+	std::size_t offset_;
+	std::vector<dynamic_dim> dims_;
+
+public:
+	dynamic_struct(std::size_t elem_size, std::vector<dynamic_dim> dims, std::size_t offset = 0)
+		: elem_size_(elem_size), offset_(offset), dims_(std::move(dims)) {}
+
+	/**
+	 * @brief creates a dense layout with the given dimensions (each character of `names` is one dimension, the last one is the innermost)
+	 */
+	static dynamic_struct dense(std::size_t elem_size, const std::string &names, const std::vector<std::size_t> &lengths) {
+		std::vector<dynamic_dim> dims(names.size());
+		std::size_t stride = elem_size;
+		for(std::size_t i = names.size(); i-- > 0;) {
+			dims[i] = dynamic_dim{names[i], lengths[i], std::ptrdiff_t(stride)};
+			stride *= lengths[i];
+		}
+		return dynamic_struct(elem_size, std::move(dims));
+	}
+
+	std::size_t elem_size() const noexcept { return elem_size_; }
+	std::size_t offset() const noexcept { return offset_; }
+	std::size_t rank() const noexcept { return dims_.size(); }
+	const std::vector<dynamic_dim> &dims() const noexcept { return dims_; }
+	const dynamic_dim &dim(std::size_t i) const noexcept { return dims_[i]; }
+
+	/**
+	 * @brief the position of the dimension in `dims()`, or `rank()` if there is no such dimension
+	 */
+	std::size_t find(char name) const noexcept {
+		std::size_t i = 0;
+		while(i < dims_.size() && dims_[i].name != name)
+			i++;
+		return i;
+	}
+
+	/**
+	 * @brief the number of elements
+	 */
+	std::size_t num_elements() const noexcept {
+		std::size_t n = 1;
+		for(const auto &d : dims_)
+			n *= d.length;
+		return n;
+	}
+
+	/**
+	 * @brief the offset of the element with the given indices (one for each dimension, in the order of `dims()`)
+	 */
+	std::size_t offset_of(const std::size_t *indices) const noexcept {
+		std::ptrdiff_t off = std::ptrdiff_t(offset_);
+		for(std::size_t i = 0; i < dims_.size(); i++)
+			off += std::ptrdiff_t(indices[i]) * dims_[i].stride;
+		return std::size_t(off);
+	}
+
+	/**
+	 * @brief the size of the memory needed for the structure (up to the end of the last element)
+	 */
+	std::size_t size() const noexcept {
+		if(num_elements() == 0)
+			return 0;
+		std::ptrdiff_t end = std::ptrdiff_t(offset_ + elem_size_);
+		for(const auto &d : dims_)
+			if(d.stride > 0)
+				end += std::ptrdiff_t(d.length - 1) * d.stride;
+		return std::size_t(end);
+	}
+
+	/**
+	 * @brief whether the elements are stored one after another without gaps, in the order of `dims()`
+	 */
+	bool is_dense() const noexcept {
+		std::size_t stride = elem_size_;
+		for(std::size_t i = dims_.size(); i-- > 0;) {
+			if(dims_[i].length > 1 && dims_[i].stride != std::ptrdiff_t(stride))
+				return false;
+			stride *= dims_[i].length;
+		}
+		return true;
+	}
+};
+
+namespace helpers {
+
+template<class Signature>
+struct dynamic_struct_dims;
+
+template<char Dim, class ArgLength, class RetSig>
+struct dynamic_struct_dims<function_sig<Dim, ArgLength, RetSig>> {
+	static_assert(ArgLength::is_known, "All the lengths must be set");
+	using type = integer_sequence_concat<char_sequence<Dim>, typename dynamic_struct_dims<RetSig>::type>;
+};
+
+template<char Dim, class... RetSigs>
+struct dynamic_struct_dims<dep_function_sig<Dim, RetSigs...>> {
+	static_assert(value_always_false<Dim>, "A dynamic_struct cannot contain tuples");
+};
+
+template<class ValueType>
+struct dynamic_struct_dims<scalar_sig<ValueType>> {
+	using type = char_sequence<>;
+};
+
+template<class Struct, char... Dims>
+dynamic_struct to_dynamic_struct(Struct s, char_sequence<Dims...>) {
+	auto zero = make_state<index_in<Dims>...>(((void)Dims, std::size_t(0))...);
+	std::size_t base = s | noarr::offset(zero);
+
+	std::vector<dynamic_dim> dims;
+	(..., [&] {
+		std::size_t length = s | get_length<Dims>();
+		std::ptrdiff_t stride = 0;
+		if(length > 1)
+			stride = std::ptrdiff_t(s | noarr::offset(zero.template with<index_in<Dims>>(std::size_t(1)))) - std::ptrdiff_t(base);
+		dims.push_back(dynamic_dim{Dims, length, stride});
+	}());
+
+	return dynamic_struct(sizeof(scalar_t<Struct>), std::move(dims), base);
+}
+
+// checks that each dimension (with the others at zero) is an arithmetic progression with the stride measured from the first two elements
+template<class Struct, char... Dims>
+bool dynamic_struct_is_affine(Struct s, const dynamic_struct &ds, char_sequence<Dims...>) noexcept {
+	auto zero = make_state<index_in<Dims>...>(((void)Dims, std::size_t(0))...);
+	std::size_t d = 0;
+	return (... && [&] {
+		const dynamic_dim &dim = ds.dim(d++);
+		for(std::size_t i = 2; i < dim.length; i++)
+			if(std::ptrdiff_t(s | noarr::offset(zero.template with<index_in<Dims>>(i))) != std::ptrdiff_t(ds.offset()) + std::ptrdiff_t(i) * dim.stride)
+				return false;
+		return true;
+	}());
+}
+
+template<char... Dims>
+bool dynamic_struct_matches(const dynamic_struct &ds, char_sequence<Dims...>) noexcept {
+	if(ds.rank() != sizeof...(Dims))
+		return false;
+	std::size_t i = 0;
+	return (... && (ds.dim(i++).name == Dims)) && ds.offset() == 0 && ds.is_dense();
+}
+
+// `Dims` are ordered from the outermost, the structure is built from the innermost
+template<class ValueType, char... Dims, std::size_t... I>
+auto dynamic_struct_to_static(const dynamic_struct &ds, char_sequence<Dims...>, std::index_sequence<I...>) noexcept {
+	constexpr std::size_t n = sizeof...(Dims);
+	constexpr char dims[] = {Dims..., '\0'};
+	return (scalar<ValueType>() ^ ... ^ sized_vector<dims[n - 1 - I]>(ds.dim(n - 1 - I).length));
+}
+
+template<class ValueType, class Candidate, class... Candidates, class F>
+bool dynamic_struct_dispatch(const dynamic_struct &ds, F &f) {
+	if(dynamic_struct_matches(ds, Candidate())) {
+		f(dynamic_struct_to_static<ValueType>(ds, Candidate(), std::make_index_sequence<Candidate::size()>()));
+		return true;
+	}
+	if constexpr(sizeof...(Candidates) > 0)
+		return dynamic_struct_dispatch<ValueType, Candidates...>(ds, f);
+	else
+		return false;
+}
+
+} // namespace helpers
+
+/**
+ * @brief describes an affine structure (e.g. composed of vectors, slices, fixes, and renames) as a `dynamic_struct`
+ *
+ * The dimensions are ordered as in the signature of the structure. The strides are measured from the element
+ * with all indices zero, then checked along each dimension (without iterating over the whole structure).
+ *
+ * @return the description, or nothing if the structure is not affine (e.g. `merge_zcurve`)
+ */
+template<class Struct>
+std::optional<dynamic_struct> to_dynamic_struct(Struct s) {
+	using dims = typename helpers::dynamic_struct_dims<typename Struct::signature>::type;
+	dynamic_struct ds = helpers::to_dynamic_struct(s, dims());
+	if(!helpers::dynamic_struct_is_affine(s, ds, dims()))
+		return std::nullopt;
+	return ds;
+}
+
+/**
+ * @brief calls `f` with a static structure equivalent to `ds`, if `ds` matches one of the `Candidates`
+ *
+ * Each candidate is a `char_sequence` of the dimension names, from the outermost one. The candidate matches if `ds` is dense
+ * (see `dynamic_struct::is_dense`) with zero offset and it has the same dimensions in the same order. The structure passed to `f`
+ * is a `scalar<ValueType>` in a `sized_vector` for each dimension (with the lengths from `ds`), so `f` is instantiated
+ * once for each candidate.
+ *
+ * @return whether a candidate matched (and `f` was called)
+ */
+template<class ValueType, class... Candidates, class F>
+bool with_static(const dynamic_struct &ds, F f) {
+	static_assert(sizeof...(Candidates) > 0, "At least one candidate layout must be given");
+	if(ds.elem_size() != sizeof(ValueType))
+		return false;
+	return helpers::dynamic_struct_dispatch<ValueType, Candidates...>(ds, f);
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_DYNAMIC_STRUCT_HPP
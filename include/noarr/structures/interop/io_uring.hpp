@@ -0,0 +1,315 @@
+#ifndef NOARR_STRUCTURES_IO_URING_HPP
+#define NOARR_STRUCTURES_IO_URING_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "async_io.hpp"
+
+namespace noarr {
+
+/**
+ * @brief an I/O backend using the Linux io_uring interface (with the buffers registered in the kernel)
+ *
+ * If io_uring is not available (e.g. an old kernel or a sandbox that forbids it), the backend falls back to a `thread_io_backend`.
+ * If the buffers cannot be registered (e.g. because of the locked memory limit), the requests use the buffers by address.
+ * If the kernel rejects a submission, the ring is not used anymore and all the later requests fail.
+ */
+class io_uring_backend {
+	enum class status : char { idle, pending, resubmit, done, failed };
+
+	struct request_state {
+		io_request request;
+		std::size_t transferred;
+		status state;
+	};
+
+	int ring_fd_ = -1;
+	void *sq_ring_ = MAP_FAILED;
+	void *cq_ring_ = MAP_FAILED;
+	io_uring_sqe *sqes_ = static_cast<io_uring_sqe *>(MAP_FAILED);
+	std::size_t sq_ring_size_ = 0;
+	std::size_t cq_ring_size_ = 0;
+	std::size_t sqes_size_ = 0;
+	unsigned *sq_tail_ = nullptr;
+	unsigned *sq_mask_ = nullptr;
+	unsigned *sq_array_ = nullptr;
+	unsigned *cq_head_ = nullptr;
+	unsigned *cq_tail_ = nullptr;
+	unsigned *cq_mask_ = nullptr;
+	io_uring_cqe *cqes_ = nullptr;
+
+	char *buffers_ = nullptr;
+	std::size_t buffer_size_ = 0;
+	bool registered_ = false;
+	std::vector<request_state> requests_;
+	std::size_t num_pending_ = 0;
+	bool broken_ = false; // a submission failed, its entry may still be in the submission queue
+
+	thread_io_backend fallback_;
+	bool use_fallback_ = false;
+
+	// the kernel limits the length of a single request
+	static constexpr std::size_t max_request = std::size_t(1) << 30;
+
+	template<class T>
+	static T *ring_field(void *ring, unsigned offset) noexcept {
+		return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+	}
+
+	bool setup(unsigned entries) noexcept {
+		io_uring_params params;
+		std::memset(&params, 0, sizeof(params));
+		params.flags = IORING_SETUP_CQSIZE;
+		params.cq_entries = 2 * entries;
+		ring_fd_ = int(::syscall(__NR_io_uring_setup, entries, &params));
+		if(ring_fd_ < 0)
+			return false;
+
+		sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+		sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+		cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+		sqes_ = static_cast<io_uring_sqe *>(::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+		if(sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED)
+			return false;
+
+		sq_tail_ = ring_field<unsigned>(sq_ring_, params.sq_off.tail);
+		sq_mask_ = ring_field<unsigned>(sq_ring_, params.sq_off.ring_mask);
+		sq_array_ = ring_field<unsigned>(sq_ring_, params.sq_off.array);
+		cq_head_ = ring_field<unsigned>(cq_ring_, params.cq_off.head);
+		cq_tail_ = ring_field<unsigned>(cq_ring_, params.cq_off.tail);
+		cq_mask_ = ring_field<unsigned>(cq_ring_, params.cq_off.ring_mask);
+		cqes_ = ring_field<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+		return true;
+	}
+
+	void teardown() noexcept {
+		if(sqes_ != MAP_FAILED)
+			::munmap(sqes_, sqes_size_);
+		if(cq_ring_ != MAP_FAILED)
+			::munmap(cq_ring_, cq_ring_size_);
+		if(sq_ring_ != MAP_FAILED)
+			::munmap(sq_ring_, sq_ring_size_);
+		if(ring_fd_ >= 0)
+			::close(ring_fd_);
+		ring_fd_ = -1;
+		sq_ring_ = cq_ring_ = MAP_FAILED;
+		sqes_ = static_cast<io_uring_sqe *>(MAP_FAILED);
+	}
+
+	bool register_buffers(std::size_t num_buffers) noexcept {
+		if(buffer_size_ > max_request)
+			return false;
+		std::vector<iovec> iovecs(num_buffers);
+		for(std::size_t i = 0; i < num_buffers; i++) {
+			iovecs[i].iov_base = buffers_ + i * buffer_size_;
+			iovecs[i].iov_len = buffer_size_;
+		}
+		return ::syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS, iovecs.data(), unsigned(num_buffers)) == 0;
+	}
+
+	// the number of the requests passed to the kernel and not completed yet (other than the one on `except`)
+	std::size_t num_in_kernel(std::size_t except) const noexcept {
+		std::size_t n = 0;
+		for(std::size_t i = 0; i < requests_.size(); i++)
+			n += i != except && requests_[i].state == status::pending;
+		return n;
+	}
+
+	// queues the (rest of the) request on the buffer and passes it to the kernel
+	bool push(std::size_t buffer) noexcept {
+		if(broken_)
+			return false;
+		const request_state &r = requests_[buffer];
+		const std::size_t rest = r.request.size - r.transferred;
+		const unsigned tail = *sq_tail_; // only this thread writes the tail
+		const unsigned index = tail & *sq_mask_;
+
+		io_uring_sqe &sqe = sqes_[index];
+		std::memset(&sqe, 0, sizeof(sqe));
+		if(registered_) {
+			sqe.opcode = r.request.write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+			sqe.buf_index = std::uint16_t(buffer);
+		} else {
+			sqe.opcode = r.request.write ? IORING_OP_WRITE : IORING_OP_READ;
+		}
+		sqe.fd = r.request.fd;
+		sqe.off = r.request.offset + r.transferred;
+		sqe.addr = reinterpret_cast<std::uintptr_t>(buffers_ + buffer * buffer_size_ + r.transferred);
+		sqe.len = unsigned(rest < max_request ? rest : max_request);
+		sqe.user_data = buffer;
+		sq_array_[index] = index;
+		__atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+		for(;;) {
+			long submitted = ::syscall(__NR_io_uring_enter, ring_fd_, 1u, 0u, 0u, nullptr, std::size_t(0));
+			if(submitted == 1)
+				return true;
+			if(submitted < 0 && errno == EINTR)
+				continue;
+			// the kernel is short of resources or the completions have to be consumed first: wait for some of the other requests
+			if(submitted < 0 && (errno == EAGAIN || errno == EBUSY) && num_in_kernel(buffer) > 0) {
+				if(!wait_completion())
+					break;
+				drain();
+				continue;
+			}
+			break;
+		}
+
+		// the entry stays in the submission queue, so the ring must not be entered with anything to submit anymore
+		broken_ = true;
+		return false;
+	}
+
+	// processes a completion (a short transfer is left for a resubmission)
+	void complete(std::size_t buffer, int result) noexcept {
+		request_state &r = requests_[buffer];
+		if(result < 0 && (result == -EINTR || result == -EAGAIN)) {
+			r.state = status::resubmit;
+			return;
+		} else if(result > 0) {
+			r.transferred += std::size_t(result);
+			if(r.transferred == r.request.size) {
+				r.state = status::done;
+				num_pending_--;
+				return;
+			}
+			r.state = status::resubmit;
+			return;
+		} else if(r.request.size == 0) {
+			r.state = status::done;
+			num_pending_--;
+			return;
+		}
+		r.state = status::failed; // an error or the end of the file
+		num_pending_--;
+	}
+
+	// processes all the available completions
+	void drain() noexcept {
+		unsigned head = *cq_head_; // only this thread writes the head
+		const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+		for(; head != tail; head++) {
+			const io_uring_cqe &cqe = cqes_[head & *cq_mask_];
+			const std::size_t buffer = std::size_t(cqe.user_data);
+			const int result = cqe.res;
+			__atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+			complete(buffer, result);
+		}
+	}
+
+	// waits until there is at least one completion (nothing is submitted)
+	bool wait_completion() noexcept {
+		while(*cq_head_ == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+			long ret = ::syscall(__NR_io_uring_enter, ring_fd_, 0u, 1u, unsigned(IORING_ENTER_GETEVENTS), nullptr, std::size_t(0));
+			if(ret < 0 && errno != EINTR)
+				return false;
+		}
+		return true;
+	}
+
+	// resubmits the rest of the short transfers, returns whether there were any
+	bool resubmit() noexcept {
+		bool any = false;
+		for(std::size_t buffer = 0; buffer < requests_.size(); buffer++) {
+			request_state &r = requests_[buffer];
+			if(r.state != status::resubmit)
+				continue;
+			any = true;
+			r.state = status::pending;
+			if(!push(buffer)) {
+				r.state = status::failed;
+				num_pending_--;
+			}
+		}
+		return any;
+	}
+
+	// makes progress on the pending requests: resubmits the short transfers, or waits for a completion and processes the available ones
+	bool progress() noexcept {
+		if(resubmit())
+			return true;
+		if(!wait_completion())
+			return false; // the ring is broken
+		drain();
+		return true;
+	}
+
+public:
+	io_uring_backend() noexcept = default;
+	io_uring_backend(const io_uring_backend &) = delete;
+	io_uring_backend &operator=(const io_uring_backend &) = delete;
+
+	~io_uring_backend() {
+		while(num_pending_ > 0 && progress()) {}
+		teardown();
+	}
+
+	/**
+	 * @brief whether io_uring is used (i.e. the backend did not fall back to threads)
+	 */
+	bool uses_io_uring() const noexcept { return !use_fallback_; }
+
+	/**
+	 * @brief whether the buffers are registered in the kernel
+	 */
+	bool buffers_registered() const noexcept { return registered_; }
+
+	bool init(char *buffers, std::size_t buffer_size, std::size_t num_buffers, std::size_t queue_depth) {
+		buffers_ = buffers;
+		buffer_size_ = buffer_size;
+		requests_.assign(num_buffers, request_state{io_request{}, 0, status::idle});
+
+		unsigned entries = 1;
+		while(entries < num_buffers)
+			entries *= 2;
+		if(!setup(entries)) {
+			teardown();
+			use_fallback_ = true;
+			return fallback_.init(buffers, buffer_size, num_buffers, queue_depth);
+		}
+		registered_ = register_buffers(num_buffers);
+		return true;
+	}
+
+	bool submit(const io_request &request) {
+		if(use_fallback_)
+			return fallback_.submit(request);
+		request_state &r = requests_[request.buffer];
+		r = request_state{request, 0, status::pending};
+		num_pending_++;
+		if(push(request.buffer))
+			return true;
+		r.state = status::idle;
+		num_pending_--;
+		return false;
+	}
+
+	bool wait(std::size_t buffer) {
+		if(use_fallback_)
+			return fallback_.wait(buffer);
+		request_state &r = requests_[buffer];
+		while(r.state == status::pending || r.state == status::resubmit)
+			if(!progress())
+				return false; // the ring is broken
+		bool ok = r.state != status::failed;
+		r.state = status::idle;
+		return ok;
+	}
+};
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_IO_URING_HPP
@@ -0,0 +1,95 @@
+#ifndef NOARR_STRUCTURES_KERNEL_REGISTRY_HPP
+#define NOARR_STRUCTURES_KERNEL_REGISTRY_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include "../extra/mangle.hpp"
+
+namespace noarr {
+
+/**
+ * @brief maps the (mangled) types of structures to kernels instantiated for them
+ *
+ * A kernel is a function object taking a structure and `Args`. It is registered (using `add`) for a list of structure types,
+ * which instantiates it for each of them. The registry is then invoked with a description of a structure produced by `mangle_expr`
+ * (e.g. read from a file header): the type part of the description is looked up in a hash table, the structure is reconstructed
+ * using `unmangle_expr`, and it is passed to the matching instantiation. If there is none, the fallback kernel (if set) gets the description.
+ *
+ * @tparam Args: the types of the other arguments of the kernels
+ */
+template<class... Args>
+class kernel_registry {
+	using kernel_fn = std::function<bool(std::string_view, Args...)>;
+	using fallback_fn = std::function<void(std::string_view, Args...)>;
+
+	// the keys point to `mangle_to_str<Struct>::c_str` (static storage)
+	std::unordered_map<std::string_view, kernel_fn> kernels_;
+	fallback_fn fallback_;
+
+	static std::string_view type_part(std::string_view description) noexcept {
+		return description.substr(0, description.find('{'));
+	}
+
+	template<class Struct, class Kernel>
+	void add_one(const Kernel &kernel) {
+		using type_str = mangle_to_str<Struct>;
+		kernels_[std::string_view(type_str::c_str, type_str::length)] = [kernel](std::string_view description, Args... args) {
+			auto s = unmangle_expr<Struct>(description);
+			if(!s)
+				return false;
+			kernel(*s, args...);
+			return true;
+		};
+	}
+
+public:
+	/**
+	 * @brief registers `kernel` for each of the `Structs` (replacing the kernels registered for them before)
+	 */
+	template<class... Structs, class Kernel>
+	void add(Kernel kernel) {
+		(..., add_one<Structs>(kernel));
+	}
+
+	/**
+	 * @brief sets the kernel called (with the description) for the structures without a registered kernel
+	 */
+	template<class Fallback>
+	void set_fallback(Fallback fallback) {
+		fallback_ = std::move(fallback);
+	}
+
+	/**
+	 * @brief the number of the structure types with a registered kernel
+	 */
+	std::size_t size() const noexcept { return kernels_.size(); }
+
+	/**
+	 * @brief whether there is a kernel registered for the type of the described structure
+	 */
+	bool contains(std::string_view description) const noexcept {
+		return kernels_.find(type_part(description)) != kernels_.end();
+	}
+
+	/**
+	 * @brief calls the kernel registered for the described structure, or the fallback
+	 *
+	 * @return whether a registered kernel was called
+	 */
+	bool operator()(std::string_view description, Args... args) const {
+		auto it = kernels_.find(type_part(description));
+		if(it != kernels_.end() && it->second(description, args...))
+			return true;
+		if(fallback_)
+			fallback_(description, args...);
+		return false;
+	}
+};
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_KERNEL_REGISTRY_HPP
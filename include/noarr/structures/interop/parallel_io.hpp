@@ -0,0 +1,250 @@
+#ifndef NOARR_STRUCTURES_PARALLEL_IO_HPP
+#define NOARR_STRUCTURES_PARALLEL_IO_HPP
+
+// the parallel I/O is built on the POSIX `pread` and `pwrite` (with file descriptors), it is not available on Windows
+#ifdef _WIN32
+#error "parallel_io.hpp requires the POSIX pread and pwrite functions"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "../extra/funcs.hpp"
+#include "../extra/struct_traits.hpp"
+#include "../extra/traverser.hpp"
+#include "../interop/bag.hpp"
+#include "../interop/traverser_iter.hpp"
+
+namespace noarr {
+
+namespace helpers {
+
+// the staging buffer of each thread (used for the parts whose elements are not contiguous in memory)
+constexpr std::size_t parallel_io_buffer_size = std::size_t(1) << 20;
+
+inline bool pwrite_all(int fd, const char *buf, std::size_t size, std::uint64_t offset) noexcept {
+	while(size > 0) {
+		ssize_t written = ::pwrite(fd, buf, size, off_t(offset));
+		if(written < 0) {
+			if(errno == EINTR)
+				continue;
+			return false;
+		}
+		buf += written;
+		size -= std::size_t(written);
+		offset += std::uint64_t(written);
+	}
+	return true;
+}
+
+inline bool pread_all(int fd, char *buf, std::size_t size, std::uint64_t offset) noexcept {
+	while(size > 0) {
+		ssize_t read = ::pread(fd, buf, size, off_t(offset));
+		if(read < 0) {
+			if(errno == EINTR)
+				continue;
+			return false;
+		}
+		if(read == 0)
+			return false; // the file is too short
+		buf += read;
+		size -= std::size_t(read);
+		offset += std::uint64_t(read);
+	}
+	return true;
+}
+
+// a part of the traversal (a range of indices in the top dimension), processed by one thread
+struct parallel_io_part {
+	std::size_t begin_idx, end_idx;
+	std::size_t num_elems = 0;
+	std::size_t first_offset = 0; // in memory
+	bool contiguous = true; // the elements are stored in memory in the traversal order without gaps
+	std::uint64_t file_offset = 0;
+};
+
+template<class Range, class F>
+void parallel_io_run(const Range &range, std::vector<parallel_io_part> &parts, const F &f) {
+	std::vector<std::thread> threads;
+	threads.reserve(parts.size() - 1);
+	for(std::size_t i = 1; i < parts.size(); i++)
+		threads.emplace_back([&range, &parts, &f, i] {
+			auto subrange = range;
+			subrange.begin_idx = parts[i].begin_idx;
+			subrange.end_idx = parts[i].end_idx;
+			f(subrange, parts[i]);
+		});
+	auto subrange = range;
+	subrange.begin_idx = parts[0].begin_idx;
+	subrange.end_idx = parts[0].end_idx;
+	f(subrange, parts[0]);
+	for(auto &thread : threads)
+		thread.join();
+}
+
+// splits the traversal of `s` among the threads and computes where each part is stored in the file
+template<class Struct>
+auto parallel_io_plan(Struct s, std::uint64_t file_offset, std::size_t num_threads) {
+	constexpr std::size_t elem_size = sizeof(scalar_t<Struct>);
+	const auto range = traverser(s).range();
+	const std::size_t length = range.size();
+
+	if(num_threads == 0)
+		num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	num_threads = std::max<std::size_t>(std::min(num_threads, length), 1);
+
+	std::vector<parallel_io_part> parts(num_threads);
+	for(std::size_t i = 0; i < num_threads; i++) {
+		parts[i].begin_idx = length * i / num_threads;
+		parts[i].end_idx = length * (i + 1) / num_threads;
+	}
+
+	parallel_io_run(range, parts, [s](const auto &subrange, parallel_io_part &part) {
+		subrange.for_each([s, &part](auto state) {
+			const std::size_t elem_offset = s | offset(state);
+			if(part.num_elems == 0)
+				part.first_offset = elem_offset;
+			else if(elem_offset != part.first_offset + part.num_elems * elem_size)
+				part.contiguous = false;
+			part.num_elems++;
+		});
+	});
+
+	for(auto &part : parts) {
+		part.file_offset = file_offset;
+		file_offset += part.num_elems * elem_size;
+	}
+
+	return std::make_pair(range, std::move(parts));
+}
+
+} // namespace helpers
+
+/**
+ * @brief writes the elements of a structure to a file (at the given offset) in binary, using multiple threads
+ *
+ * The elements are stored in the traversal order, without any gaps, in the native byte order. The traversal is split among the threads
+ * by the top dimension, each thread writes its part using `pwrite` (directly from `data` if the part is contiguous in memory,
+ * otherwise through a staging buffer). Only available on POSIX systems.
+ *
+ * @param fd: a file descriptor open for writing
+ * @param file_offset: the position of the first element in the file
+ * @param s: the structure of `data` (its top dimension must be dynamic)
+ * @param num_threads: the number of threads, zero means `std::thread::hardware_concurrency()`
+ * @return whether all the elements were written
+ */
+template<class Struct, class = std::enable_if_t<is_struct<Struct>::value>>
+bool pwrite_data(int fd, std::uint64_t file_offset, Struct s, const void *data, std::size_t num_threads = 0) {
+	using value_type = scalar_t<Struct>;
+	auto [range, parts] = helpers::parallel_io_plan(s, file_offset, num_threads);
+	std::atomic<bool> ok = true;
+
+	helpers::parallel_io_run(range, parts, [fd, s, data, &ok](const auto &subrange, const helpers::parallel_io_part &part) {
+		const auto *bytes = static_cast<const char *>(data);
+		if(part.contiguous) {
+			if(!helpers::pwrite_all(fd, bytes + part.first_offset, part.num_elems * sizeof(value_type), part.file_offset))
+				ok = false;
+			return;
+		}
+
+		std::vector<char> buffer(std::max(helpers::parallel_io_buffer_size / sizeof(value_type), std::size_t(1)) * sizeof(value_type));
+		std::size_t used = 0;
+		std::uint64_t file_pos = part.file_offset;
+		bool part_ok = true;
+		subrange.for_each([&](auto state) {
+			if(!part_ok)
+				return;
+			std::memcpy(buffer.data() + used, bytes + (s | offset(state)), sizeof(value_type));
+			used += sizeof(value_type);
+			if(used == buffer.size()) {
+				part_ok = helpers::pwrite_all(fd, buffer.data(), used, file_pos);
+				file_pos += used;
+				used = 0;
+			}
+		});
+		if(!part_ok || !helpers::pwrite_all(fd, buffer.data(), used, file_pos))
+			ok = false;
+	});
+
+	return ok;
+}
+
+/**
+ * @brief writes the elements of a bag to a file in binary, using multiple threads (see the other overload)
+ */
+template<class Bag, class = decltype(std::declval<const Bag &>().structure())>
+bool pwrite_data(int fd, std::uint64_t file_offset, const Bag &bag, std::size_t num_threads = 0) {
+	return pwrite_data(fd, file_offset, bag.structure(), bag.data(), num_threads);
+}
+
+/**
+ * @brief reads the elements of a structure from a file written by `pwrite_data` (with the same structure and traversal order), using multiple threads
+ *
+ * @param fd: a file descriptor open for reading
+ * @param file_offset: the position of the first element in the file
+ * @param s: the structure of `data` (its top dimension must be dynamic)
+ * @param num_threads: the number of threads, zero means `std::thread::hardware_concurrency()`
+ * @return whether all the elements were read (`false` on an error or if the file is too short)
+ */
+template<class Struct, class = std::enable_if_t<is_struct<Struct>::value>>
+bool pread_data(int fd, std::uint64_t file_offset, Struct s, void *data, std::size_t num_threads = 0) {
+	using value_type = scalar_t<Struct>;
+	auto [range, parts] = helpers::parallel_io_plan(s, file_offset, num_threads);
+	std::atomic<bool> ok = true;
+
+	helpers::parallel_io_run(range, parts, [fd, s, data, &ok](const auto &subrange, const helpers::parallel_io_part &part) {
+		auto *bytes = static_cast<char *>(data);
+		if(part.contiguous) {
+			if(!helpers::pread_all(fd, bytes + part.first_offset, part.num_elems * sizeof(value_type), part.file_offset))
+				ok = false;
+			return;
+		}
+
+		std::vector<char> buffer(std::max(helpers::parallel_io_buffer_size / sizeof(value_type), std::size_t(1)) * sizeof(value_type));
+		std::size_t used = 0, filled = 0;
+		std::uint64_t file_pos = part.file_offset;
+		std::uint64_t file_end = part.file_offset + part.num_elems * sizeof(value_type);
+		bool part_ok = true;
+		subrange.for_each([&](auto state) {
+			if(!part_ok)
+				return;
+			if(used == filled) {
+				filled = std::size_t(std::min<std::uint64_t>(buffer.size(), file_end - file_pos));
+				part_ok = helpers::pread_all(fd, buffer.data(), filled, file_pos);
+				file_pos += filled;
+				used = 0;
+				if(!part_ok)
+					return;
+			}
+			std::memcpy(bytes + (s | offset(state)), buffer.data() + used, sizeof(value_type));
+			used += sizeof(value_type);
+		});
+		if(!part_ok)
+			ok = false;
+	});
+
+	return ok;
+}
+
+/**
+ * @brief reads the elements of a bag from a file written by `pwrite_data`, using multiple threads (see the other overload)
+ */
+template<class Bag, class = decltype(std::declval<const Bag &>().structure())>
+bool pread_data(int fd, std::uint64_t file_offset, Bag &&bag, std::size_t num_threads = 0) {
+	return pread_data(fd, file_offset, bag.structure(), bag.data(), num_threads);
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_PARALLEL_IO_HPP
@@ -1,8 +1,25 @@
 #ifndef NOARR_STRUCTURES_SERIALIZE_DATA_HPP
 #define NOARR_STRUCTURES_SERIALIZE_DATA_HPP
 
+#include <algorithm>
+#include <charconv>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <ios>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../extra/struct_traits.hpp"
 #include "../extra/traverser.hpp"
 #include "../interop/bag.hpp"
+#include "../interop/traverser_iter.hpp"
 
 namespace noarr {
 
@@ -32,6 +49,186 @@ constexpr decltype(auto) serialize_data(Ostream &&out, const Bag &bag) noexcept
 	return serialize_data(std::forward<Ostream>(out), bag.structure(), bag.data());
 }
 
+namespace helpers {
+
+// how many chunks (ranges of the top dimension) each thread formats
+constexpr std::size_t serialize_chunks_per_thread = 8;
+
+// the longest text of a number (`to_chars` produces the shortest round-trip representation of floating-point numbers)
+template<class T>
+constexpr std::size_t serialize_max_length() noexcept {
+	return std::is_floating_point_v<T> ? 64 : std::numeric_limits<T>::digits10 + 3;
+}
+
+template<class T>
+constexpr void serialize_check_type() noexcept {
+	static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "The fast text serialization only supports numbers");
+}
+
+template<class Range, class Struct>
+void serialize_chunk(const Range &subrange, Struct s, const void *data, std::string &text) {
+	using value_type = scalar_t<Struct>;
+	constexpr std::size_t max_length = serialize_max_length<value_type>();
+	std::size_t used = 0;
+	text.resize(text.capacity());
+	subrange.for_each([&](auto state) {
+		if(text.size() - used < max_length + 1)
+			text.resize(std::max(2 * text.size(), used + max_length + 1));
+		char *first = text.data() + used;
+		char *last = std::to_chars(first, text.data() + text.size(), s | get_at(data, state)).ptr;
+		*last = '\n';
+		used = last + 1 - text.data();
+	});
+	text.resize(used);
+}
+
+constexpr bool is_text_space(int c) noexcept {
+	return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// parses the whole token [first, last), there must be room for a terminating null character at `last`
+template<class T>
+bool serialize_parse(const char *first, char *last, T &value) noexcept {
+#ifndef __cpp_lib_to_chars
+	// `from_chars` for floating-point numbers is missing in some standard libraries (e.g. libc++ before 20), `strtod` is used instead
+	if constexpr(std::is_floating_point_v<T>) {
+		*last = '\0';
+		char *end;
+		errno = 0;
+		if constexpr(std::is_same_v<T, float>)
+			value = std::strtof(first, &end);
+		else if constexpr(std::is_same_v<T, double>)
+			value = std::strtod(first, &end);
+		else
+			value = std::strtold(first, &end);
+		return end == last && end != first && !(errno == ERANGE && std::isinf(value));
+	} else
+#endif
+	{
+		auto [end, error] = std::from_chars(first, last, value);
+		return error == std::errc() && end == last;
+	}
+}
+
+} // namespace helpers
+
+/**
+ * @brief writes the elements of a structure to a text stream, like `serialize_data`, but formats them using `std::to_chars` (in parallel)
+ *
+ * The traversal is split to chunks by the top dimension, the chunks are formatted by `num_threads` threads into their own buffers,
+ * and each chunk is written to the stream by a single `write`. The stream formatting state and locale are ignored,
+ * floating-point numbers are written in the shortest form that reads back to the same value.
+ *
+ * @param out: the output stream (of `char`s)
+ * @param s: the structure of `data` (its top dimension must be dynamic, the elements must be numbers)
+ * @param num_threads: the number of threads, zero means `std::thread::hardware_concurrency()`
+ */
+template<class Ostream, class Struct, class = std::enable_if_t<is_struct<Struct>::value>>
+decltype(auto) serialize_data_fast(Ostream &&out, Struct s, const void *data, std::size_t num_threads = 0) {
+	helpers::serialize_check_type<scalar_t<Struct>>();
+	const auto range = traverser(s).range();
+	const std::size_t length = range.size();
+	if(num_threads == 0)
+		num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	const std::size_t num_chunks = std::min(length, num_threads * helpers::serialize_chunks_per_thread);
+
+	// the chunks are formatted in waves of `num_threads`, the buffers are reused
+	std::vector<std::string> texts(std::min(num_threads, std::max<std::size_t>(num_chunks, 1)));
+	for(std::size_t wave = 0; wave < num_chunks && out; wave += texts.size()) {
+		const std::size_t wave_size = std::min(texts.size(), num_chunks - wave);
+		auto format = [&](std::size_t i) {
+			auto subrange = range;
+			subrange.begin_idx = length * (wave + i) / num_chunks;
+			subrange.end_idx = length * (wave + i + 1) / num_chunks;
+			helpers::serialize_chunk(subrange, s, data, texts[i]);
+		};
+
+		std::vector<std::thread> threads;
+		for(std::size_t i = 1; i < wave_size; i++)
+			threads.emplace_back(format, i);
+		format(0);
+		for(auto &thread : threads)
+			thread.join();
+
+		for(std::size_t i = 0; i < wave_size && out; i++)
+			out.write(texts[i].data(), std::streamsize(texts[i].size()));
+	}
+	return std::forward<Ostream>(out);
+}
+
+template<class Ostream, class Bag, class = decltype(std::declval<const Bag &>().structure())>
+decltype(auto) serialize_data_fast(Ostream &&out, const Bag &bag, std::size_t num_threads = 0) {
+	return serialize_data_fast(std::forward<Ostream>(out), bag.structure(), bag.data(), num_threads);
+}
+
+/**
+ * @brief reads the elements of a structure from a text stream, like `deserialize_data`, but parses them using `std::from_chars`
+ *
+ * The characters are taken directly from the stream buffer (any whitespace separates the numbers), the stream formatting state and locale are ignored.
+ * No characters after the last number are consumed. If a number is missing or malformed, `failbit` is set (and the rest of the elements are left unchanged),
+ * reaching the end of the input sets `eofbit`. Unlike `operator>>`, a number longer than `to_chars` could write (not counting its leading zeros) is malformed.
+ *
+ * @param in: the input stream (of `char`s)
+ * @param s: the structure of `data` (the elements must be numbers)
+ */
+template<class Istream, class Struct>
+decltype(auto) deserialize_data_fast(Istream &&in, Struct s, void *data) {
+	using value_type = scalar_t<Struct>;
+	helpers::serialize_check_type<value_type>();
+	using traits = typename std::remove_reference_t<Istream>::traits_type;
+	auto *buf = in.rdbuf();
+	bool ok = in.good() && buf != nullptr;
+	bool eof = false;
+
+	traverser(s).for_each([&](auto state) {
+		if(!ok)
+			return;
+		auto c = buf->sgetc();
+		while(!traits::eq_int_type(c, traits::eof()) && helpers::is_text_space(c))
+			c = buf->snextc();
+
+		// a token longer than any number is malformed (the last character is left for a terminating null character)
+		constexpr std::size_t limit = helpers::serialize_max_length<value_type>() + 1;
+		char token[limit + 1];
+		std::size_t n = 0;
+		auto is = [&c](char lo, char hi) { return !traits::eq_int_type(c, traits::eof()) && traits::to_char_type(c) >= lo && traits::to_char_type(c) <= hi; };
+
+		const bool plus = is('+', '+'); // accepted by `operator>>`, but not by `from_chars`
+		if(plus || is('-', '-')) {
+			if(!plus)
+				token[n++] = '-';
+			c = buf->snextc();
+		}
+		const bool second_sign = is('+', '+') || is('-', '-');
+		// the leading zeros do not count to the length (one is kept if no other digit follows)
+		bool zeros = false;
+		for(; is('0', '0'); c = buf->snextc())
+			zeros = true;
+		if(zeros && !is('1', '9'))
+			token[n++] = '0';
+
+		while(!traits::eq_int_type(c, traits::eof()) && !helpers::is_text_space(c) && n < limit) {
+			token[n++] = traits::to_char_type(c);
+			c = buf->snextc();
+		}
+		eof = traits::eq_int_type(c, traits::eof());
+
+		if(n == 0 || n == limit || second_sign || !helpers::serialize_parse(token, token + n, s | get_at(data, state)))
+			ok = false;
+	});
+
+	if(eof) // like `operator>>`, which stops at the end of the input
+		in.setstate(std::ios_base::eofbit);
+	if(!ok)
+		in.setstate(std::ios_base::failbit);
+	return std::forward<Istream>(in);
+}
+
+template<class Istream, class Bag>
+decltype(auto) deserialize_data_fast(Istream &&in, Bag &&bag) {
+	return deserialize_data_fast(std::forward<Istream>(in), bag.structure(), bag.data());
+}
+
 } // namespace noarr
 
 #endif // NOARR_STRUCTURES_SERIALIZE_DATA_HPP
@@ -0,0 +1,228 @@
+#ifndef NOARR_STRUCTURES_SORT_HPP
+#define NOARR_STRUCTURES_SORT_HPP
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../extra/funcs.hpp"
+#include "../extra/struct_traits.hpp"
+#include "../extra/to_struct.hpp"
+#include "../extra/traverser.hpp"
+#include "../interop/bag.hpp"
+#include "../structs/layouts.hpp"
+#include "../structs/setters.hpp"
+
+namespace noarr {
+
+namespace helpers {
+
+// runs `f(i)` for all `i` in `[0, n)`, the parallel versions (in tbb.hpp) provide the same interface
+struct sort_sequential_runner {
+	template<class F>
+	void operator()(std::size_t n, const F &f) const noexcept {
+		for(std::size_t i = 0; i < n; i++)
+			f(i);
+	}
+};
+
+template<class Key>
+constexpr bool sort_radix_key = std::is_integral_v<Key> && !std::is_same_v<Key, bool>;
+
+// maps the key to an unsigned integer with the same order
+template<class Key>
+constexpr auto sort_radix_bits(Key key) noexcept {
+	using unsigned_t = std::make_unsigned_t<Key>;
+	if constexpr(std::is_signed_v<Key>)
+		return unsigned_t(unsigned_t(key) ^ unsigned_t(unsigned_t(1) << (sizeof(Key) * CHAR_BIT - 1)));
+	else
+		return unsigned_t(key);
+}
+
+constexpr std::size_t sort_radix_digit_bits = 8;
+constexpr std::size_t sort_radix_buckets = std::size_t(1) << sort_radix_digit_bits;
+
+// one stable pass of the LSD radix sort, from `from` to `to`, both split into `blocks` equal parts (processed by `run`)
+template<class Bits, class Runner>
+inline void sort_radix_pass(const std::vector<std::pair<Bits, std::size_t>> &from, std::vector<std::pair<Bits, std::size_t>> &to, std::size_t shift, std::size_t blocks, const Runner &run) noexcept {
+	const std::size_t n = from.size();
+	const std::size_t block_size = (n + blocks - 1) / blocks;
+	std::vector<std::size_t> offsets(blocks * sort_radix_buckets);
+
+	run(blocks, [&](std::size_t block) {
+		std::size_t *histogram = &offsets[block * sort_radix_buckets];
+		for(std::size_t i = block * block_size; i < n && i < (block + 1) * block_size; i++)
+			histogram[(from[i].first >> shift) & (sort_radix_buckets - 1)]++;
+	});
+
+	// exclusive prefix sum, digit-major (so that the order of the blocks is kept within each digit)
+	std::size_t sum = 0;
+	for(std::size_t digit = 0; digit < sort_radix_buckets; digit++) {
+		for(std::size_t block = 0; block < blocks; block++) {
+			std::size_t count = offsets[block * sort_radix_buckets + digit];
+			offsets[block * sort_radix_buckets + digit] = sum;
+			sum += count;
+		}
+	}
+
+	run(blocks, [&](std::size_t block) {
+		std::size_t *offset = &offsets[block * sort_radix_buckets];
+		for(std::size_t i = block * block_size; i < n && i < (block + 1) * block_size; i++)
+			to[offset[(from[i].first >> shift) & (sort_radix_buckets - 1)]++] = from[i];
+	});
+}
+
+// the state needed to query the length of `Dim` (in case it is nested in a tuple, the first branch is used)
+template<char Dim, class Signature>
+struct sort_length_state {
+	template<class State>
+	static constexpr State get(State state) noexcept { return state; }
+};
+template<char Dim, char QDim, class ArgLength, class RetSig>
+struct sort_length_state<Dim, function_sig<QDim, ArgLength, RetSig>> : sort_length_state<Dim, RetSig> {};
+template<char Dim, class ArgLength, class RetSig>
+struct sort_length_state<Dim, function_sig<Dim, ArgLength, RetSig>> : sort_length_state<Dim, scalar_sig<void>> {};
+template<char Dim, char QDim, class RetSig, class... RetSigs>
+struct sort_length_state<Dim, dep_function_sig<QDim, RetSig, RetSigs...>> {
+	template<class State>
+	static constexpr auto get(State state) noexcept { return sort_length_state<Dim, RetSig>::get(state.template with<index_in<QDim>>(lit<0>)); }
+};
+
+template<char Dim, class Struct>
+constexpr std::size_t sort_length(Struct structure) noexcept {
+	return structure.template length<Dim>(sort_length_state<Dim, typename Struct::signature>::get(empty_state));
+}
+
+// the stable permutation that sorts the entries of `structure` along `Dim` by `key_fn`
+template<char Dim, class Struct, class KeyFn, class Runner, class Sort>
+inline std::vector<std::size_t> sort_permutation(Struct structure, KeyFn key_fn, const Runner &run, std::size_t blocks, const Sort &sort) noexcept {
+	using key_t = std::decay_t<decltype(key_fn(empty_state.with<index_in<Dim>>(std::size_t(0))))>;
+	const std::size_t n = sort_length<Dim>(structure);
+	std::vector<std::size_t> perm(n);
+
+	if constexpr(sort_radix_key<key_t>) {
+		using bits_t = decltype(sort_radix_bits(std::declval<key_t>()));
+		std::vector<std::pair<bits_t, std::size_t>> items(n), tmp(n);
+		run(n, [&](std::size_t i) {
+			items[i] = {sort_radix_bits(key_t(key_fn(empty_state.with<index_in<Dim>>(i)))), i};
+		});
+		bits_t all_ones = 0, all_zeros = bits_t(~bits_t(0));
+		for(const auto &item : items) {
+			all_ones |= item.first;
+			all_zeros &= item.first;
+		}
+		for(std::size_t shift = 0; shift < sizeof(bits_t) * CHAR_BIT; shift += sort_radix_digit_bits) {
+			// skip the digits that are the same in all keys
+			if((((all_ones ^ all_zeros) >> shift) & (sort_radix_buckets - 1)) == 0)
+				continue;
+			sort_radix_pass(items, tmp, shift, blocks, run);
+			items.swap(tmp);
+		}
+		run(n, [&](std::size_t i) { perm[i] = items[i].second; });
+	} else {
+		std::vector<std::pair<key_t, std::size_t>> items(n);
+		run(n, [&](std::size_t i) {
+			items[i] = {key_fn(empty_state.with<index_in<Dim>>(i)), i};
+		});
+		// the index breaks the ties, so the result is stable even if `sort` is not
+		sort(items.begin(), items.end(), [](const auto &a, const auto &b) {
+			return a.first < b.first || (!(b.first < a.first) && a.second < b.second);
+		});
+		run(n, [&](std::size_t i) { perm[i] = items[i].second; });
+	}
+
+	return perm;
+}
+
+// whether `Struct` is a vector in `Dim` with a set length (e.g. `sized_vector` or `array`): the entries along `Dim` are then contiguous and equally spaced
+template<char Dim, class Struct>
+struct sort_is_top_vector : std::false_type {};
+template<char Dim, class T, class LenT>
+struct sort_is_top_vector<Dim, set_length_t<Dim, vector<Dim, T>, LenT>> : std::true_type {};
+
+// the distance between two consecutive entries along `Dim` if it is known to be uniform (and the entries start at zero), zero otherwise
+template<char Dim, class Struct>
+inline std::size_t sort_entry_stride(Struct structure) noexcept {
+	if constexpr(sort_is_top_vector<Dim, Struct>::value) {
+		const std::size_t n = structure.template length<Dim>(empty_state);
+		return n ? std::size_t(structure | get_size()) / n : 0;
+	} else {
+		(void)structure;
+		return 0;
+	}
+}
+
+template<char Dim, class Bag, class Perm, class Runner>
+inline void permute_impl(const Bag &bag, const Perm &perm, const Runner &run) noexcept {
+	auto structure = bag.structure();
+	const std::size_t n = sort_length<Dim>(structure);
+	const std::size_t size = structure | get_size();
+	char *data = (char *)bag.data();
+
+	// the original data, from which the entries are gathered
+	std::vector<char> staging(size);
+	std::memcpy(staging.data(), data, size);
+
+	if(std::size_t stride = sort_entry_stride<Dim>(structure)) {
+		run(n, [=, &perm, &staging](std::size_t i) {
+			std::memcpy(data + i * stride, staging.data() + std::size_t(perm[i]) * stride, stride);
+		});
+	} else {
+		auto from = make_bag(structure, (const void *)staging.data());
+		auto t = traverser(structure);
+		run(n, [&](std::size_t i) {
+			const std::size_t j = perm[i];
+			t.order(fix<Dim>(i)).for_each([&bag, &from, j](auto state) {
+				bag[state] = from[state.template with<index_in<Dim>>(j)];
+			});
+		});
+	}
+}
+
+} // namespace helpers
+
+/**
+ * @brief reorders the entries of `bag` along the dimension `Dim`: the `i`-th entry is replaced by the original `perm[i]`-th entry
+ *
+ * An entry consists of all elements with the given index in `Dim` (it does not have to be contiguous in memory).
+ * If `bag` is a vector in `Dim` (e.g. `sized_vector` or `array` is its outermost layer), each entry is copied at once, otherwise it is copied element by element.
+ *
+ * @tparam Dim: the permuted dimension
+ * @param bag: the bag, its data are modified in place
+ * @param perm: a permutation of the indices in `Dim` (e.g. `std::vector<std::size_t>`)
+ */
+template<char Dim, class Bag, class Perm>
+inline void permute(const Bag &bag, const Perm &perm) noexcept {
+	helpers::permute_impl<Dim>(bag, perm, helpers::sort_sequential_runner());
+}
+
+/**
+ * @brief stably sorts the entries of `bag` along the dimension `Dim` by the keys returned by `key_fn`
+ *
+ * Integral keys are sorted using the radix sort, other keys using the merge sort (they must be comparable using `<`).
+ * The keys are all computed before the data are modified.
+ *
+ * @tparam Dim: the sorted dimension
+ * @param bag: the bag, its data are modified in place
+ * @param key_fn: a function that gets a state with the index in `Dim` and returns the key of the corresponding entry
+ * @return the applied permutation (which can be then used in `permute`)
+ */
+template<char Dim, class Bag, class KeyFn>
+inline std::vector<std::size_t> sort_along(const Bag &bag, KeyFn key_fn) noexcept {
+	auto perm = helpers::sort_permutation<Dim>(bag.structure(), key_fn, helpers::sort_sequential_runner(), 1, [](auto begin, auto end, auto less) {
+		std::stable_sort(begin, end, less);
+	});
+	helpers::permute_impl<Dim>(bag, perm, helpers::sort_sequential_runner());
+	return perm;
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_SORT_HPP
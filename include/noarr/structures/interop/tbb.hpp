@@ -3,10 +3,16 @@
 
 #include <cstdlib>
 #include <type_traits>
+#include <vector>
 #include <tbb/tbb.h>
 
+#include "../extra/gather.hpp"
+#include "../extra/reduce.hpp"
+#include "../extra/stencil.hpp"
 #include "../interop/bag.hpp"
+#include "../interop/sort.hpp"
 #include "../interop/traverser_iter.hpp"
+#include "../structs/views.hpp"
 
 namespace noarr {
 
@@ -23,6 +29,31 @@ inline void tbb_for_each(const Traverser &t, const F &f) noexcept {
 	tbb::parallel_for(t.range(), [&f](const auto &subrange) { subrange.for_each(f); });
 }
 
+// creates a bag (see `make_uninitialized_bag`) and initializes each element in parallel to `f(state)`;
+// each page is first touched by the thread that initializes it (on NUMA systems, it is allocated on the node of that thread),
+// so a later `tbb_for_each` over the same traversal tends to access memory local to its threads
+template<class Structure, class F>
+inline auto tbb_make_bag(Structure s, const F &f) noexcept {
+	auto bag = make_uninitialized_bag(s);
+	tbb_for_each(traverser(bag), [&bag, &f](auto state) { bag[state] = f(state); });
+	return bag;
+}
+
+namespace helpers {
+
+// a thread-local copy of the output, allocated lazily
+struct tbb_private_ptr {
+	void *raw;
+	constexpr tbb_private_ptr() noexcept : raw(nullptr) {}
+	tbb_private_ptr(const tbb_private_ptr &) = delete;
+	tbb_private_ptr(tbb_private_ptr &&) = delete;
+	tbb_private_ptr &operator=(const tbb_private_ptr &) = delete;
+	tbb_private_ptr &operator=(tbb_private_ptr &&) = delete;
+	~tbb_private_ptr() { std::free(raw); } // ok with null
+};
+
+} // namespace helpers
+
 template<class Traverser, class FNeut, class FAcc, class FJoin, class OutStruct>
 inline void tbb_reduce(const Traverser &t, const FNeut &f_neut, const FAcc &f_acc, const FJoin &f_join, const OutStruct &out_struct, void *out_ptr) noexcept {
 	constexpr char top_dim = helpers::traviter_top_dim<decltype(t.get_struct() ^ t.get_order())>;
@@ -36,15 +67,7 @@ inline void tbb_reduce(const Traverser &t, const FNeut &f_neut, const FAcc &f_ac
 		});
 	} else {
 		// parallel writes may go to colliding offsets => out_ptr must be privatized
-		struct private_ptr {
-			void *raw;
-			constexpr private_ptr() noexcept : raw(nullptr) {}
-			private_ptr(const private_ptr &) = delete;
-			private_ptr(private_ptr &&) = delete;
-			private_ptr &operator=(const private_ptr &) = delete;
-			private_ptr &operator=(private_ptr &&) = delete;
-			~private_ptr() { std::free(raw); } // ok with null
-		};
+		using private_ptr = helpers::tbb_private_ptr;
 		tbb::combinable<private_ptr> out_ptrs;
 		tbb::parallel_for(t.range(), [&f_neut, &f_acc, &out_struct, &out_ptrs](const range_t &subrange) {
 			private_ptr &local = out_ptrs.local();
@@ -89,6 +112,117 @@ inline void tbb_reduce_bag(const Traverser &t, const FNeut &f_neut, const FAcc &
 		out_bag.data());
 }
 
+template<char Dim, class InBag, class OutBag, class Op>
+inline void tbb_reduce_along(const InBag &in, const OutBag &out, Op op) noexcept {
+	using impl_t = helpers::reduce_along_impl<Dim, InBag, OutBag, Op>;
+	impl_t impl{in, out, op};
+	if constexpr(impl_t::accumulate_locally) {
+		tbb_for_each(traverser(out), [&impl](auto state) { impl.reduce_one(state); });
+	} else {
+		// split the input along the top-level dimension of the output => parallel writes go to different offsets
+		constexpr char top_dim = helpers::traviter_top_dim<typename impl_t::out_struct>;
+		tbb_for_each(traverser(out), [&impl](auto state) { impl.init_one(state); });
+		tbb_for_each(traverser(in, out).order(hoist<top_dim>()), [&impl](auto state) { impl.accumulate_one(state); });
+	}
+}
+
+template<class Traverser, char... Dims, class F>
+inline void tbb_for_each_tile(const stencil_tiles_t<Traverser, Dims...> &tiles, const F &f) noexcept {
+	tbb::parallel_for(std::size_t(0), tiles.size(), [&tiles, &f](std::size_t i) { tiles[i].for_each(f); });
+}
+
+// like `fill_halo`, but each slab of the halo is filled in parallel
+template<char... Dims, class Bag, class Policy>
+inline void tbb_fill_halo(const Bag &bag, const Policy &policy) noexcept {
+	helpers::fill_halo<Dims...>(bag, policy, [](std::size_t count, const auto &f) { tbb::parallel_for(std::size_t(0), count, f); });
+}
+
+template<char Dim, class InBag, class IdxBag, class OutBag>
+inline void tbb_gather(const InBag &in, const IdxBag &idx, const OutBag &out) noexcept {
+	auto t = traverser(idx, out);
+	helpers::gather_impl<Dim, IdxBag, OutBag> impl{idx, t.top_struct()};
+	tbb_for_each(t, [&in, &out, &impl](auto state) {
+		impl.prefetch_ahead(in, state);
+		out[state] = in[impl.indirect_state(state)];
+	});
+}
+
+// the indices must not repeat (otherwise it is unspecified which of the colliding elements is stored)
+template<char Dim, class InBag, class IdxBag, class OutBag>
+inline void tbb_scatter(const InBag &in, const IdxBag &idx, const OutBag &out) noexcept {
+	auto t = traverser(idx, in);
+	helpers::gather_impl<Dim, IdxBag, InBag> impl{idx, t.top_struct()};
+	tbb_for_each(t, [&in, &out, &impl](auto state) {
+		impl.prefetch_ahead(out, state);
+		out[impl.indirect_state(state)] = in[state];
+	});
+}
+
+template<char Dim, class InBag, class IdxBag, class OutBag, class Op>
+inline void tbb_scatter(const InBag &in, const IdxBag &idx, const OutBag &out, Op op) noexcept {
+	static_assert(Op::in_place, "The operation must accumulate directly in the output");
+	using in_t = scalar_t<typename to_struct<InBag>::type>;
+	using out_t = scalar_t<typename to_struct<OutBag>::type>;
+	auto out_struct = to_struct<OutBag>::convert(out);
+	auto t = traverser(idx, in);
+	using range_t = decltype(t.range());
+	helpers::gather_impl<Dim, IdxBag, InBag> impl{idx, t.top_struct()};
+
+	// the indices may collide => each thread accumulates into its own copy of the output
+	tbb::combinable<helpers::tbb_private_ptr> out_ptrs;
+	tbb::parallel_for(t.range(), [&in, &impl, op, out_struct, &out_ptrs](const range_t &subrange) {
+		helpers::tbb_private_ptr &local = out_ptrs.local();
+		if(local.raw == nullptr) {
+			local.raw = std::malloc(out_struct | get_size());
+			auto local_out = make_bag(out_struct, local.raw);
+			traverser(local_out).for_each([&local_out, op](auto state) {
+				local_out[state] = op.template neutral<in_t, out_t>();
+			});
+		}
+		auto local_out = make_bag(out_struct, local.raw);
+		subrange.for_each([&in, &impl, &local_out, op](auto state) {
+			impl.prefetch_ahead(local_out, state);
+			op(local_out[impl.indirect_state(state)], in[state], 0);
+		});
+	});
+	out_ptrs.combine_each([&out, op, out_struct](const helpers::tbb_private_ptr &local) {
+		auto local_out = make_bag(out_struct, (const void *)local.raw);
+		traverser(out).for_each([&out, &local_out, op](auto state) {
+			op(out[state], local_out[state], 0);
+		});
+	});
+}
+
+namespace helpers {
+
+struct sort_tbb_runner {
+	template<class F>
+	void operator()(std::size_t n, const F &f) const noexcept {
+		tbb::parallel_for(std::size_t(0), n, f);
+	}
+};
+
+// the number of elements processed by one task in a radix sort pass
+constexpr std::size_t sort_tbb_radix_block = std::size_t(1) << 16;
+
+} // namespace helpers
+
+template<char Dim, class Bag, class Perm>
+inline void tbb_permute(const Bag &bag, const Perm &perm) noexcept {
+	helpers::permute_impl<Dim>(bag, perm, helpers::sort_tbb_runner());
+}
+
+template<char Dim, class Bag, class KeyFn>
+inline std::vector<std::size_t> tbb_sort_along(const Bag &bag, KeyFn key_fn) noexcept {
+	std::size_t n = helpers::sort_length<Dim>(bag.structure());
+	std::size_t blocks = (n + helpers::sort_tbb_radix_block - 1) / helpers::sort_tbb_radix_block;
+	auto perm = helpers::sort_permutation<Dim>(bag.structure(), key_fn, helpers::sort_tbb_runner(), blocks ? blocks : 1, [](auto begin, auto end, auto less) {
+		tbb::parallel_sort(begin, end, less);
+	});
+	helpers::permute_impl<Dim>(bag, perm, helpers::sort_tbb_runner());
+	return perm;
+}
+
 } // namespace noarr
 
 #endif // NOARR_STRUCTURES_TBB_HPP
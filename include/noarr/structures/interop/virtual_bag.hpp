@@ -0,0 +1,212 @@
+#ifndef NOARR_VIRTUAL_BAG_HPP
+#define NOARR_VIRTUAL_BAG_HPP
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "../base/contain.hpp"
+#include "../base/state.hpp"
+#include "../base/structs_common.hpp"
+#include "../extra/funcs.hpp"
+#include "../extra/struct_traits.hpp"
+#include "../extra/to_struct.hpp"
+#include "../structs/bcast.hpp"
+#include "../structs/scalar.hpp"
+
+namespace noarr {
+
+/**
+ * @brief A virtual bag computes its values from the indices instead of storing them: `bag[state]` returns `generator(state)`.
+ *
+ * It can be used in place of a read-only bag, e.g. in `traverser(a, b)`, `reduce_along`, or as the indices of `gather`.
+ * The generator is called directly in the loop body, so the compiler can fuse it with the computation (and vectorize it),
+ * with no memory traffic for the generated values.
+ *
+ * @tparam Structure: the dimensions, their lengths, and the value type (the scalar) of the bag, the structure is never allocated
+ * @tparam Generator: computes the value from a state with the indices in the dimensions of `Base`
+ * @tparam Base: the structure the generator was created for (`Structure` without the protos applied later using `operator^`)
+ */
+template<class Structure, class Generator, class Base = Structure>
+class virtual_bag : contain<Structure> {
+	using base = contain<Structure>;
+
+	Generator generator_;
+
+public:
+	explicit constexpr virtual_bag(Structure s, Generator generator) noexcept : base(s), generator_(generator)
+	{ }
+
+	/**
+	 * @brief returns the structure that describes the dimensions of the bag
+	 */
+	constexpr auto structure() const noexcept { return base::template get<0>(); }
+
+	/**
+	 * @brief returns the function that computes the values
+	 */
+	constexpr const Generator &generator() const noexcept { return generator_; }
+
+	/**
+	 * @brief computes the value at the given state (the indices are mapped through the protos applied using `operator^`)
+	 */
+	template<class State>
+	constexpr auto operator[](State state) const noexcept {
+		return generator()(state_at<Base>(structure(), state));
+	}
+
+	/**
+	 * @brief computes the value at the given indices
+	 *
+	 * @tparam Dims: the dimension names
+	 * @param ts: the dimension values
+	 */
+	template<char... Dims, class... Ts>
+	constexpr auto at(Ts... ts) const noexcept {
+		return (*this)[empty_state.with<index_in<Dims>...>(ts...)];
+	}
+
+	/**
+	 * @brief gets the length (number of indices) of a dimension in the `structure`
+	 *
+	 * @tparam Dim: the dimension name
+	 */
+	template<char Dim>
+	constexpr auto get_length() const noexcept {
+		return structure() | noarr::get_length<Dim>();
+	}
+
+	template<class ProtoStruct, class = std::enable_if_t<ProtoStruct::proto_preserves_layout>>
+	friend constexpr auto operator ^(const virtual_bag &b, ProtoStruct p) noexcept {
+		auto new_struct = b.structure() ^ p;
+		return virtual_bag<decltype(new_struct), Generator, Base>(new_struct, b.generator());
+	}
+};
+
+/**
+ * @brief creates a virtual bag whose values are computed by `generator(state)`, see `virtual_bag`
+ *
+ * @param s: the structure (it gives the dimensions and the value type)
+ * @param generator: the function of the state, it is given the indices in the dimensions of `s`
+ */
+template<class Structure, class Generator>
+constexpr auto make_virtual_bag(Structure s, Generator generator) noexcept {
+	return virtual_bag<Structure, Generator>(s, generator);
+}
+
+namespace helpers {
+
+template<char Dim, class T>
+struct virtual_iota_generator {
+	template<class State>
+	constexpr T operator()(State state) const noexcept { return T(state.template get<index_in<Dim>>()); }
+};
+
+template<class T>
+struct virtual_constant_generator {
+	T value;
+
+	template<class State>
+	constexpr T operator()(State) const noexcept { return value; }
+};
+
+template<char Dim, class T>
+struct virtual_grid_generator {
+	T origin;
+	T step;
+
+	template<class State>
+	constexpr T operator()(State state) const noexcept { return origin + step * T(state.template get<index_in<Dim>>()); }
+};
+
+// the finalizer of SplitMix64: a bijective mix of all the bits
+constexpr std::uint64_t virtual_random_mix(std::uint64_t x) noexcept {
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9u;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBu;
+	return x ^ (x >> 31);
+}
+
+// uniform in [0, 1) for floating-point types (only as many bits as the mantissa holds, so the result never rounds up to 1), the low bits otherwise
+template<class T>
+constexpr T virtual_random_value(std::uint64_t bits) noexcept {
+	if constexpr(std::is_floating_point_v<T>) {
+		constexpr int digits = std::numeric_limits<T>::digits < 53 ? std::numeric_limits<T>::digits : 53;
+		return T(bits >> (64 - digits)) * (T(1) / T(std::uint64_t(1) << digits));
+	} else {
+		return T(bits);
+	}
+}
+
+template<class Struct>
+struct virtual_random_generator {
+	Struct structure;
+	std::uint64_t seed;
+
+	// the counter is the offset of the element in the (never allocated) structure, so the values do not depend on the traversal order
+	template<class State>
+	constexpr auto operator()(State state) const noexcept {
+		using type = scalar_t<Struct, State>;
+		const std::uint64_t counter = offset_of<scalar<type>>(structure, state);
+		return virtual_random_value<type>(virtual_random_mix(virtual_random_mix(seed) + counter * 0x9E3779B97F4A7C15u));
+	}
+};
+
+} // namespace helpers
+
+/**
+ * @brief a virtual bag with the value `i` at the index `i` in `Dim` (the length is taken from the other bags in a traversal, or set using `set_length`)
+ *
+ * @tparam Dim: the dimension name
+ * @tparam T: the value type
+ */
+template<char Dim, class T = std::size_t>
+constexpr auto virtual_iota() noexcept {
+	return make_virtual_bag(scalar<T>() ^ bcast<Dim>(), helpers::virtual_iota_generator<Dim, T>());
+}
+
+/**
+ * @brief a virtual bag with the same value at all the indices in `Dims` (the lengths are taken from the other bags in a traversal, or set using `set_length`)
+ *
+ * @tparam Dims: the dimension names (none for a single value)
+ * @param value: the value
+ */
+template<char... Dims, class T>
+constexpr auto virtual_constant(T value) noexcept {
+	return make_virtual_bag(scalar<T>() ^ bcast<Dims...>(), helpers::virtual_constant_generator<T>{value});
+}
+
+/**
+ * @brief a virtual bag of the coordinates `origin + step * i` of a uniform grid in `Dim` (the length is taken from the other bags in a traversal, or set using `set_length`)
+ *
+ * @tparam Dim: the dimension name
+ * @param origin: the coordinate at the index zero
+ * @param step: the distance between neighboring coordinates
+ */
+template<char Dim, class T>
+constexpr auto virtual_grid(T origin, T step) noexcept {
+	return make_virtual_bag(scalar<T>() ^ bcast<Dim>(), helpers::virtual_grid_generator<Dim, T>{origin, step});
+}
+
+/**
+ * @brief a virtual bag of pseudo-random values computed from a counter (the offset of the element in `s`) and a seed
+ *
+ * The same element always gets the same value, regardless of the traversal order or the number of threads.
+ * Floating-point values are uniform in [0, 1), integral values are uniform in their whole range.
+ *
+ * @param s: the structure (it gives the dimensions, their lengths, and the value type, its offsets are the counters)
+ * @param seed: the seed, the values for different seeds are independent
+ */
+template<class Structure>
+constexpr auto virtual_random(Structure s, std::uint64_t seed) noexcept {
+	return make_virtual_bag(s, helpers::virtual_random_generator<Structure>{s, seed});
+}
+
+template<class T, class G, class B>
+struct to_struct<virtual_bag<T, G, B>> {
+	using type = T;
+	static constexpr T convert(const virtual_bag<T, G, B> &b) noexcept { return b.structure(); }
+};
+
+} // namespace noarr
+
+#endif // NOARR_VIRTUAL_BAG_HPP
@@ -0,0 +1,169 @@
+#ifndef NOARR_STRUCTURES_AOSOA_HPP
+#define NOARR_STRUCTURES_AOSOA_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "../base/contain.hpp"
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../base/structs_common.hpp"
+#include "../base/utility.hpp"
+#include "../extra/funcs.hpp"
+#include "../extra/to_struct.hpp"
+
+namespace noarr {
+
+/**
+ * @brief an array of structures of arrays: a vector of records (a tuple) stored in chunks of `Width` records,
+ * each chunk stores `Width` copies of the first field, then `Width` copies of the second field, and so on
+ *
+ * The last chunk is padded to `Width` records. Like `vector`, the length has to be set (using `set_length`) before the structure is used.
+ *
+ * @tparam Dim: the dimension of the records
+ * @tparam Width: the number of records in a chunk (usually the SIMD width)
+ * @tparam T: the structure of a record, it must be a tuple (its fields are usually scalars)
+ */
+template<char Dim, std::size_t Width, class T>
+struct aosoa_t : contain<T> {
+	using base = contain<T>;
+	using base::base;
+
+	static constexpr char name[] = "aosoa_t";
+	using params = struct_params<
+		dim_param<Dim>,
+		value_param<std::size_t, Width>,
+		structure_param<T>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+
+	static_assert(Width > 0, "The chunk width must be positive");
+	static_assert(T::signature::dependent, "The record of an AoSoA must be a tuple");
+	static_assert(!T::signature::template any_accept<Dim>, "Dimension name already used");
+	static constexpr char field_dim = T::signature::dim;
+	static constexpr std::size_t width = Width;
+
+	using signature = function_sig<Dim, unknown_arg_length, typename T::signature>;
+
+	template<class State>
+	constexpr auto size(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		static_assert(State::template contains<length_in<Dim>>, "Unknown AoSoA length");
+		auto len = state.template get<length_in<Dim>>();
+		auto num_chunks = (len + make_const<Width - 1>()) / make_const<Width>();
+		return num_chunks * make_const<Width>() * sub_structure().size(state.template remove<index_in<Dim>, length_in<Dim>, index_in<field_dim>>());
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		static_assert(State::template contains<index_in<Dim>>, "All indices must be set");
+		static_assert(State::template contains<index_in<field_dim>>, "All indices must be set");
+		static_assert(state_get_t<State, index_in<field_dim>>::value || true, "Tuple index must be set statically, wrap it in lit<> (e.g. replace 42 with lit<42>)");
+		constexpr std::size_t field = state_get_t<State, index_in<field_dim>>::value;
+		auto index = state.template get<index_in<Dim>>();
+		auto sub_state = state.template remove<index_in<Dim>, length_in<Dim>, index_in<field_dim>>();
+		auto field_struct = sub_structure().template sub_structure<field>();
+		// offset = chunk * chunk_size + Width * size_of_previous_fields + lane * field_size + offset_within_field
+		auto chunk_offset = index / make_const<Width>() * make_const<Width>() * sub_structure().size(sub_state);
+		auto field_offset = make_const<Width>() * fields_size(std::make_index_sequence<field>(), sub_state);
+		auto lane_offset = index % make_const<Width>() * field_struct.size(sub_state);
+		return chunk_offset + field_offset + lane_offset + offset_of<Sub>(field_struct, sub_state);
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		if constexpr(QDim == Dim) {
+			static_assert(!State::template contains<index_in<Dim>>, "Index already set");
+			static_assert(State::template contains<length_in<Dim>>, "This length has not been set yet");
+			return state.template get<length_in<Dim>>();
+		} else {
+			return sub_structure().template length<QDim>(state.template remove<index_in<Dim>, length_in<Dim>>());
+		}
+	}
+
+	template<class Sub, class State>
+	constexpr void strict_state_at(State) const noexcept {
+		static_assert(value_always_false<Dim>, "An aosoa_t cannot be used in this context");
+	}
+
+private:
+	template<std::size_t... IS, class State>
+	constexpr auto fields_size(std::index_sequence<IS...>, State sub_state) const noexcept {
+		using namespace constexpr_arithmetic;
+		(void) sub_state; // don't complain about unused parameter in case of empty fold
+		return (make_const<0>() + ... + sub_structure().template sub_structure<IS>().size(sub_state));
+	}
+};
+
+template<char Dim, std::size_t Width>
+struct aosoa_proto {
+	static constexpr bool proto_preserves_layout = false;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return aosoa_t<Dim, Width, Struct>(s); }
+};
+
+/**
+ * @brief stores a tuple (a record) in an array of structures of arrays layout, see `aosoa_t` (used in place of `vector<Dim>()`)
+ *
+ * @tparam Dim: the dimension of the records
+ * @tparam Width: the number of records in a chunk
+ */
+template<char Dim, std::size_t Width>
+constexpr auto aosoa() noexcept { return aosoa_proto<Dim, Width>(); }
+
+namespace helpers {
+
+template<char Dim, class Struct, class = void>
+struct aosoa_width_impl {
+	static_assert(always_false<Struct>, "The structure does not contain an AoSoA in this dimension");
+};
+
+template<char Dim, class Struct>
+static constexpr bool is_aosoa_in = false;
+
+template<char Dim, std::size_t Width, class T>
+static constexpr bool is_aosoa_in<Dim, aosoa_t<Dim, Width, T>> = true;
+
+template<char Dim, std::size_t Width, class T>
+struct aosoa_width_impl<Dim, aosoa_t<Dim, Width, T>> : std::integral_constant<std::size_t, Width> {};
+
+// look through the structures that wrap the AoSoA (e.g. set_length_t)
+template<char Dim, class Struct>
+struct aosoa_width_impl<Dim, Struct, std::enable_if_t<!is_aosoa_in<Dim, Struct>, std::void_t<decltype(std::declval<Struct>().sub_structure())>>>
+	: aosoa_width_impl<Dim, decltype(std::declval<Struct>().sub_structure())> {};
+
+} // namespace helpers
+
+/**
+ * @brief the number of records in a chunk of the AoSoA in `Dim` (which may be wrapped in other structures, e.g. `set_length`)
+ */
+template<char Dim, class Struct>
+constexpr std::size_t aosoa_width = helpers::aosoa_width_impl<Dim, Struct>::value;
+
+/**
+ * @brief calls `f(state, lanes)` for each chunk of an AoSoA: `state` has the index (in `Dim`) of the first record of the chunk
+ * and `lanes` is the number of records in the chunk
+ *
+ * For each field, the `lanes` values starting at `state` (with the field index added) are contiguous in memory, so they can be processed by SIMD instructions.
+ * In all chunks except the last one, `lanes` is the static `lit<Width>`, the last (incomplete) chunk gets a dynamic `std::size_t`.
+ *
+ * @param s: a structure (or a bag) with an AoSoA in `Dim` (the other dimensions, except the field dimension, must be fixed by the state)
+ * @param state: the indices in the other dimensions (if any)
+ */
+template<char Dim, class Struct, class F, class State = state<>>
+constexpr void aosoa_for_each_chunk(const Struct &s, F f, State state = empty_state) {
+	constexpr std::size_t width = aosoa_width<Dim, typename to_struct<Struct>::type>;
+	const std::size_t length = to_struct<Struct>::convert(s) | get_length<Dim>(state);
+	std::size_t first = 0;
+	for(; first + width <= length; first += width)
+		f(state.template with<index_in<Dim>>(first), lit<width>);
+	if(first < length)
+		f(state.template with<index_in<Dim>>(first), length - first);
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_AOSOA_HPP
@@ -0,0 +1,229 @@
+#ifndef NOARR_STRUCTURES_BITPACK_HPP
+#define NOARR_STRUCTURES_BITPACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "../base/contain.hpp"
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../base/structs_common.hpp"
+#include "../base/utility.hpp"
+#include "../extra/funcs.hpp"
+#include "../extra/struct_traits.hpp"
+#include "../extra/to_struct.hpp"
+#include "scalar.hpp"
+
+namespace noarr {
+
+/**
+ * @brief a vector of sub-byte scalars packed into bytes: `8 / N` values per byte, the first one in the least significant bits
+ *
+ * The size is rounded up to whole 64-bit words, so the packed data can be processed a word at a time (see `bitpack_transform`).
+ * Like `vector`, the length has to be set (using `set_length`) before the structure is used.
+ * The offsets of the elements are `bit_offset`s, `get_at` and bags return `bits_ref` proxies.
+ *
+ * @tparam Dim: the dimension name added by the structure
+ * @tparam T: the packed scalar, `scalar_bits<N>`
+ */
+template<char Dim, class T>
+struct bitpack_t : contain<T> {
+	using base = contain<T>;
+	using base::base;
+
+	static constexpr char name[] = "bitpack_t";
+	using params = struct_params<
+		dim_param<Dim>,
+		structure_param<T>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+
+	using value_type = scalar_t<T>;
+	static_assert(helpers::is_bits<value_type>, "Only sub-byte scalars (scalar_bits) can be packed");
+	static constexpr std::size_t width = value_type::width;
+	static constexpr std::size_t per_byte = 8 / width;
+
+	using signature = function_sig<Dim, unknown_arg_length, typename T::signature>;
+
+	template<class State>
+	constexpr auto size(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		static_assert(State::template contains<length_in<Dim>>, "Unknown bitpack length");
+		auto len = state.template get<length_in<Dim>>();
+		return (len * make_const<width>() + make_const<63>()) / make_const<64>() * make_const<8>();
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		static_assert(std::is_same_v<Sub, T>, "Substructure was not found");
+		static_assert(State::template contains<index_in<Dim>>, "All indices must be set");
+		auto index = state.template get<index_in<Dim>>();
+		return bit_offset{std::size_t(index / make_const<per_byte>()), std::size_t(index % make_const<per_byte>() * make_const<width>())};
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		static_assert(QDim == Dim, "Index in this dimension is not accepted by any substructure");
+		static_assert(!State::template contains<index_in<Dim>>, "Index already set");
+		static_assert(State::template contains<length_in<Dim>>, "This length has not been set yet");
+		return state.template get<length_in<Dim>>();
+	}
+
+	template<class Sub, class State>
+	constexpr void strict_state_at(State) const noexcept {
+		static_assert(value_always_false<Dim>, "A bitpack_t cannot be used in this context");
+	}
+};
+
+template<char Dim>
+struct bitpack_proto {
+	static constexpr bool proto_preserves_layout = false;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return bitpack_t<Dim, Struct>(s); }
+};
+
+/**
+ * @brief packs sub-byte scalars (`scalar_bits<N>`) into bytes, see `bitpack_t` (used in place of `vector<Dim>()`)
+ *
+ * @tparam Dim: the dimension name added by the structure
+ */
+template<char Dim>
+constexpr auto bitpack() noexcept { return bitpack_proto<Dim>(); }
+
+namespace helpers {
+
+template<char Dim, class Bag>
+constexpr auto bitpack_data(const Bag &bag) noexcept {
+	const auto off = to_struct<Bag>::convert(bag) | offset<Dim>(lit<0>);
+	static_assert(std::is_same_v<decltype(off), const bit_offset>, "The structure is not bit-packed in this dimension");
+	return sub_ptr<unsigned char>(bag.data(), off.bytes);
+}
+
+template<char Dim, class Bag>
+constexpr std::size_t bitpack_bits(const Bag &bag) noexcept {
+	return (bag | get_length<Dim>()) * scalar_t<typename to_struct<Bag>::type>::width;
+}
+
+// the mask of the first `bits` bits of a word loaded from memory (bits < 64)
+inline std::uint64_t bitpack_tail_mask(std::size_t bits) noexcept {
+	unsigned char bytes[sizeof(std::uint64_t)] = {};
+	std::size_t i = 0;
+	for(; i < bits / 8; i++)
+		bytes[i] = 0xFF;
+	bytes[i] = (unsigned char)((1u << bits % 8) - 1);
+	std::uint64_t mask;
+	std::memcpy(&mask, bytes, sizeof(mask));
+	return mask;
+}
+
+inline std::uint64_t bitpack_load(const unsigned char *ptr) noexcept {
+	std::uint64_t word;
+	std::memcpy(&word, ptr, sizeof(word));
+	return word;
+}
+
+inline std::size_t bitpack_popcount_word(std::uint64_t word) noexcept {
+#if defined(__GNUC__)
+	return (std::size_t)__builtin_popcountll(word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555u);
+	word = (word & 0x3333333333333333u) + ((word >> 2) & 0x3333333333333333u);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+	return (std::size_t)((word * 0x0101010101010101u) >> 56);
+#endif
+}
+
+} // namespace helpers
+
+/**
+ * @brief returns the number of set bits in a bag with a `bitpack` in `Dim` (for one-bit scalars, the number of ones)
+ *
+ * The bag must have no other dimensions (they can be fixed using `fix`). The bits are counted a 64-bit word at a time.
+ */
+template<char Dim, class Bag>
+std::size_t bitpack_popcount(const Bag &bag) noexcept {
+	const auto data = helpers::bitpack_data<Dim>(bag);
+	const std::size_t bits = helpers::bitpack_bits<Dim>(bag);
+	std::size_t count = 0, i = 0;
+	for(; i + 64 <= bits; i += 64)
+		count += helpers::bitpack_popcount_word(helpers::bitpack_load(data + i / 8));
+	if(i < bits)
+		count += helpers::bitpack_popcount_word(helpers::bitpack_load(data + i / 8) & helpers::bitpack_tail_mask(bits - i));
+	return count;
+}
+
+/**
+ * @brief computes `out = f(ins...)` a 64-bit word at a time, where `f` is a bitwise function of `std::uint64_t` words (e.g. `a & ~b`)
+ *
+ * All the bags must have a `bitpack` of the same length in `Dim` and no other dimensions (they can be fixed using `fix`).
+ * The bits of `out` past its length are preserved.
+ */
+template<char Dim, class F, class Out, class... Ins>
+void bitpack_transform(F f, const Out &out, const Ins &...ins) noexcept {
+	const auto out_data = helpers::bitpack_data<Dim>(out);
+	const std::size_t bits = helpers::bitpack_bits<Dim>(out);
+	std::size_t i = 0;
+	for(; i + 64 <= bits; i += 64) {
+		const std::uint64_t word = f(helpers::bitpack_load(helpers::bitpack_data<Dim>(ins) + i / 8)...);
+		std::memcpy(out_data + i / 8, &word, sizeof(word));
+	}
+	if(i < bits) {
+		const std::uint64_t mask = helpers::bitpack_tail_mask(bits - i);
+		const std::uint64_t old = helpers::bitpack_load(out_data + i / 8);
+		const std::uint64_t word = (old & ~mask) | (f(helpers::bitpack_load(helpers::bitpack_data<Dim>(ins) + i / 8)...) & mask);
+		std::memcpy(out_data + i / 8, &word, sizeof(word));
+	}
+}
+
+/**
+ * @brief unpacks all the values of a bag with a `bitpack` in `Dim` into an array of `T` (e.g. `std::uint8_t` or `float`)
+ *
+ * The bag must have no other dimensions (they can be fixed using `fix`). The loop over each byte has a constant trip count, so it vectorizes well.
+ */
+template<char Dim, class Bag, class T>
+void bitpack_unpack(const Bag &bag, T *values) noexcept {
+	using value_type = scalar_t<typename to_struct<Bag>::type>;
+	constexpr std::size_t width = value_type::width;
+	constexpr std::size_t per_byte = 8 / width;
+	const auto data = helpers::bitpack_data<Dim>(bag);
+	const std::size_t length = bag | get_length<Dim>();
+	const std::size_t full = length / per_byte;
+	for(std::size_t b = 0; b < full; b++) {
+		const unsigned byte = data[b];
+		for(std::size_t k = 0; k < per_byte; k++)
+			values[b * per_byte + k] = T((byte >> (k * width)) & value_type::mask);
+	}
+	for(std::size_t i = full * per_byte; i < length; i++)
+		values[i] = T((unsigned(data[full]) >> ((i - full * per_byte) * width)) & value_type::mask);
+}
+
+/**
+ * @brief packs an array of values (converted to `unsigned`, only the low bits are kept) into a bag with a `bitpack` in `Dim`
+ *
+ * The bag must have no other dimensions (they can be fixed using `fix`). The bits past the length are preserved.
+ */
+template<char Dim, class Bag, class T>
+void bitpack_pack(const Bag &bag, const T *values) noexcept {
+	using value_type = scalar_t<typename to_struct<Bag>::type>;
+	constexpr std::size_t width = value_type::width;
+	constexpr std::size_t per_byte = 8 / width;
+	const auto data = helpers::bitpack_data<Dim>(bag);
+	const std::size_t length = bag | get_length<Dim>();
+	const std::size_t full = length / per_byte;
+	for(std::size_t b = 0; b < full; b++) {
+		unsigned byte = 0;
+		for(std::size_t k = 0; k < per_byte; k++)
+			byte |= (unsigned(values[b * per_byte + k]) & value_type::mask) << (k * width);
+		data[b] = (unsigned char)byte;
+	}
+	for(std::size_t i = full * per_byte; i < length; i++)
+		bits_ref<width, unsigned char>(data + full, (i - full * per_byte) * width) = unsigned(values[i]);
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_BITPACK_HPP
@@ -0,0 +1,213 @@
+#ifndef NOARR_STRUCTURES_BYTES_HPP
+#define NOARR_STRUCTURES_BYTES_HPP
+
+#include "../base/contain.hpp"
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../base/structs_common.hpp"
+#include "../base/utility.hpp"
+#include "../extra/struct_traits.hpp"
+#include "scalar.hpp"
+
+namespace noarr {
+
+namespace helpers {
+
+template<char Dim, class Signature>
+struct as_bytes_sig;
+
+template<char Dim, char QDim, class ArgLength, class RetSig>
+struct as_bytes_sig<Dim, function_sig<QDim, ArgLength, RetSig>> {
+	using type = function_sig<QDim, ArgLength, typename as_bytes_sig<Dim, RetSig>::type>;
+};
+
+template<char Dim, char QDim, class... RetSigs>
+struct as_bytes_sig<Dim, dep_function_sig<QDim, RetSigs...>> {
+	using type = dep_function_sig<QDim, typename as_bytes_sig<Dim, RetSigs>::type...>;
+};
+
+template<char Dim, class ValueType>
+struct as_bytes_sig<Dim, scalar_sig<ValueType>> {
+	using type = function_sig<Dim, static_arg_length<sizeof(ValueType)>, scalar_sig<unsigned char>>;
+};
+
+template<class Signature>
+struct byte_planes_sig;
+
+template<char QDim, class ArgLength, class RetSig>
+struct byte_planes_sig<function_sig<QDim, ArgLength, RetSig>> {
+	using type = function_sig<QDim, ArgLength, typename byte_planes_sig<RetSig>::type>;
+};
+
+template<char QDim, class... RetSigs>
+struct byte_planes_sig<dep_function_sig<QDim, RetSigs...>> {
+	static_assert(value_always_false<QDim>, "Byte planes cannot be used with tuples");
+};
+
+template<class ValueType>
+struct byte_planes_sig<scalar_sig<ValueType>> {
+	using type = scalar_sig<unsigned char>;
+};
+
+} // namespace helpers
+
+/**
+ * @brief exposes the bytes of each element of a structure as an innermost dimension (the elements become `unsigned char`s)
+ *
+ * @tparam Dim: the name of the new dimension
+ * @tparam T: the structure
+ */
+template<char Dim, class T>
+struct as_bytes_t : contain<T> {
+	using base = contain<T>;
+	using base::base;
+
+	static constexpr char name[] = "as_bytes_t";
+	using params = struct_params<
+		dim_param<Dim>,
+		structure_param<T>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+
+	static_assert(!T::signature::template any_accept<Dim>, "Dimension name already used");
+	using signature = typename helpers::as_bytes_sig<Dim, typename T::signature>::type;
+
+	template<class State>
+	constexpr auto sub_state(State state) const noexcept {
+		return state.template remove<index_in<Dim>, length_in<Dim>>();
+	}
+
+	template<class State>
+	constexpr auto size(State state) const noexcept {
+		return sub_structure().size(sub_state(state));
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		if constexpr(std::is_same_v<Sub, scalar<unsigned char>>) {
+			static_assert(State::template contains<index_in<Dim>>, "All indices must be set");
+			using value_type = scalar_t<T, decltype(sub_state(state))>;
+			return offset_of<scalar<value_type>>(sub_structure(), sub_state(state)) + state.template get<index_in<Dim>>();
+		} else {
+			return offset_of<Sub>(sub_structure(), sub_state(state));
+		}
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		if constexpr(QDim == Dim) {
+			static_assert(!State::template contains<index_in<Dim>>, "Index already set");
+			return make_const<sizeof(scalar_t<T, decltype(sub_state(state))>)>();
+		} else {
+			return sub_structure().template length<QDim>(sub_state(state));
+		}
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_state_at(State state) const noexcept {
+		return state_at<Sub>(sub_structure(), sub_state(state));
+	}
+};
+
+template<char Dim>
+struct as_bytes_proto {
+	static constexpr bool proto_preserves_layout = true;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return as_bytes_t<Dim, Struct>(s); }
+};
+
+/**
+ * @brief exposes the bytes of each element of a structure as a new (innermost) dimension
+ *
+ * @tparam Dim: the name of the new dimension
+ */
+template<char Dim>
+constexpr auto as_bytes() noexcept { return as_bytes_proto<Dim>(); }
+
+/**
+ * @brief views a structure as byte planes: the `k`-th bytes of all its elements are stored together (in the order of the elements), then the next bytes, etc.
+ *
+ * The view has the same size as the structure, the new dimension is the outermost one and it selects the plane (the elements become `unsigned char`s).
+ * Copying from `s ^ as_bytes<Dim>()` to `s ^ byte_planes<Dim>()` thus shuffles the bytes of `s` (and copying back unshuffles them).
+ *
+ * @tparam Dim: the name of the new dimension
+ * @tparam T: the structure (without tuples)
+ */
+template<char Dim, class T>
+struct byte_planes_t : contain<T> {
+	using base = contain<T>;
+	using base::base;
+
+	static constexpr char name[] = "byte_planes_t";
+	using params = struct_params<
+		dim_param<Dim>,
+		structure_param<T>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+
+	static_assert(!T::signature::template any_accept<Dim>, "Dimension name already used");
+	using value_type = scalar_t<T>;
+	using signature = function_sig<Dim, static_arg_length<sizeof(value_type)>, typename helpers::byte_planes_sig<typename T::signature>::type>;
+
+	template<class State>
+	constexpr auto sub_state(State state) const noexcept {
+		return state.template remove<index_in<Dim>, length_in<Dim>>();
+	}
+
+	template<class State>
+	constexpr auto size(State state) const noexcept {
+		return sub_structure().size(sub_state(state));
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		if constexpr(std::is_same_v<Sub, scalar<unsigned char>>) {
+			static_assert(State::template contains<index_in<Dim>>, "All indices must be set");
+			constexpr auto elem_size = make_const<sizeof(value_type)>();
+			auto plane_size = sub_structure().size(sub_state(state)) / elem_size;
+			return state.template get<index_in<Dim>>() * plane_size + offset_of<scalar<value_type>>(sub_structure(), sub_state(state)) / elem_size;
+		} else {
+			return offset_of<Sub>(sub_structure(), sub_state(state));
+		}
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		if constexpr(QDim == Dim) {
+			static_assert(!State::template contains<index_in<Dim>>, "Index already set");
+			return make_const<sizeof(value_type)>();
+		} else {
+			return sub_structure().template length<QDim>(sub_state(state));
+		}
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_state_at(State state) const noexcept {
+		return state_at<Sub>(sub_structure(), sub_state(state));
+	}
+};
+
+template<char Dim>
+struct byte_planes_proto {
+	static constexpr bool proto_preserves_layout = false;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return byte_planes_t<Dim, Struct>(s); }
+};
+
+/**
+ * @brief views a structure as byte planes, with a new (outermost) dimension selecting the plane
+ *
+ * @tparam Dim: the name of the new dimension
+ */
+template<char Dim>
+constexpr auto byte_planes() noexcept { return byte_planes_proto<Dim>(); }
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_BYTES_HPP
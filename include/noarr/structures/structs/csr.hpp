@@ -0,0 +1,116 @@
+#ifndef NOARR_STRUCTURES_CSR_HPP
+#define NOARR_STRUCTURES_CSR_HPP
+
+#include <cstddef>
+
+#include "../base/contain.hpp"
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../base/structs_common.hpp"
+#include "../base/utility.hpp"
+
+namespace noarr {
+
+/**
+ * @brief a compressed sparse layout: the rows in `DimRow` have different lengths in `DimNz`, given by the row pointer array
+ *
+ * The elements of the row `i` are stored one after another, starting at the element number `row_ptr[i]`,
+ * the length of the row is `row_ptr[i+1] - row_ptr[i]`. The array must have `nrows + 1` items and it is not copied.
+ *
+ * @tparam DimRow: the outer (compressed) dimension
+ * @tparam DimNz: the inner dimension, its length depends on the index in `DimRow`
+ * @tparam T: the structure of one stored element
+ * @tparam IndexT: the type of the items of the row pointer array
+ */
+template<char DimRow, char DimNz, class T, class IndexT>
+struct csr_t : contain<T, const IndexT *, std::size_t> {
+	using base = contain<T, const IndexT *, std::size_t>;
+	using base::base;
+
+	static constexpr char name[] = "csr_t";
+	using params = struct_params<
+		dim_param<DimRow>,
+		dim_param<DimNz>,
+		structure_param<T>,
+		type_param<IndexT>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+	constexpr const IndexT *row_ptr() const noexcept { return base::template get<1>(); }
+	constexpr std::size_t nrows() const noexcept { return base::template get<2>(); }
+
+	static_assert(DimRow != DimNz, "Dimension names must be different");
+	static_assert(!T::signature::template any_accept<DimRow>, "Dimension name already used");
+	static_assert(!T::signature::template any_accept<DimNz>, "Dimension name already used");
+	using signature = function_sig<DimRow, dynamic_arg_length, function_sig<DimNz, dynamic_arg_length, typename T::signature>>;
+
+	// the length of a row depends on the index in `DimRow`
+	template<char QDim>
+	static constexpr bool dependent_length = QDim == DimNz;
+
+	template<class State>
+	constexpr auto sub_state(State state) const noexcept {
+		static_assert(!State::template contains<length_in<DimRow>>, "Cannot set csr length");
+		static_assert(!State::template contains<length_in<DimNz>>, "Cannot set csr length");
+		return state.template remove<index_in<DimRow>, index_in<DimNz>>();
+	}
+
+	template<class State>
+	constexpr std::size_t size(State state) const noexcept {
+		return std::size_t(row_ptr()[nrows()]) * sub_structure().size(sub_state(state));
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		static_assert(State::template contains<index_in<DimRow>>, "All indices must be set");
+		static_assert(State::template contains<index_in<DimNz>>, "All indices must be set");
+		std::size_t row = state.template get<index_in<DimRow>>();
+		std::size_t nz = state.template get<index_in<DimNz>>();
+		auto sub_struct = sub_structure();
+		auto sub_st = sub_state(state);
+		return (std::size_t(row_ptr()[row]) + nz) * sub_struct.size(sub_st) + offset_of<Sub>(sub_struct, sub_st);
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		if constexpr(QDim == DimRow) {
+			static_assert(!State::template contains<index_in<DimRow>>, "Index already set");
+			return nrows();
+		} else if constexpr(QDim == DimNz) {
+			static_assert(!State::template contains<index_in<DimNz>>, "Index already set");
+			static_assert(State::template contains<index_in<DimRow>>, "The length of a row depends on the row index, which has not been set yet");
+			std::size_t row = state.template get<index_in<DimRow>>();
+			return std::size_t(row_ptr()[row + 1] - row_ptr()[row]);
+		} else {
+			return sub_structure().template length<QDim>(sub_state(state));
+		}
+	}
+
+	template<class Sub, class State>
+	constexpr void strict_state_at(State) const noexcept {
+		static_assert(value_always_false<DimRow>, "A csr_t cannot be used in this context");
+	}
+};
+
+template<char DimRow, char DimNz, class IndexT>
+struct csr_proto : contain<const IndexT *, std::size_t> {
+	using base = contain<const IndexT *, std::size_t>;
+	using base::base;
+
+	static constexpr bool proto_preserves_layout = false;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return csr_t<DimRow, DimNz, Struct, IndexT>(s, base::template get<0>(), base::template get<1>()); }
+};
+
+/**
+ * @brief creates a compressed sparse row (CSR) layout, see `csr_t` (for CSC, use the column dimension as `DimRow`)
+ *
+ * @param row_ptr: the row pointer array (`nrows + 1` items, the first one is usually zero)
+ * @param nrows: the number of rows
+ */
+template<char DimRow, char DimNz, class IndexT>
+constexpr auto csr(const IndexT *row_ptr, std::size_t nrows) noexcept { return csr_proto<DimRow, DimNz, IndexT>(row_ptr, nrows); }
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_CSR_HPP
@@ -0,0 +1,285 @@
+#ifndef NOARR_STRUCTURES_PAD_HPP
+#define NOARR_STRUCTURES_PAD_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include "../base/contain.hpp"
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../base/structs_common.hpp"
+#include "../base/utility.hpp"
+
+namespace noarr {
+
+/**
+ * @brief adds `before` and `after` halo elements around a dimension: the index `i` refers to the index `i + before` in the sub-structure
+ *
+ * The length is the length of the interior (the sub-structure length minus the halo), the halo indices are `-before` to `-1` (wrapped as `std::size_t`,
+ * e.g. from `neighbor`) and `length` to `length + after - 1`. If the sub-structure length is not set, the interior length set later (using `set_length`)
+ * is extended by the halo, so the halo is allocated automatically.
+ *
+ * @tparam Dim: the padded dimension
+ * @tparam T: the sub-structure
+ * @tparam BeforeT, AfterT: the types of the halo widths
+ */
+template<char Dim, class T, class BeforeT, class AfterT>
+struct pad_t : contain<T, BeforeT, AfterT> {
+	using base = contain<T, BeforeT, AfterT>;
+	using base::base;
+
+	static constexpr char name[] = "pad_t";
+	using params = struct_params<
+		dim_param<Dim>,
+		structure_param<T>,
+		type_param<BeforeT>,
+		type_param<AfterT>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+	constexpr BeforeT before() const noexcept { return base::template get<1>(); }
+	constexpr AfterT after() const noexcept { return base::template get<2>(); }
+
+private:
+	template<class Original>
+	struct dim_replacement;
+	template<class ArgLength, class RetSig>
+	struct dim_replacement<function_sig<Dim, ArgLength, RetSig>> {
+		template<class L, class B, class A>
+		struct subtract { using type = dynamic_arg_length; };
+		template<class B, class A>
+		struct subtract<unknown_arg_length, B, A> { using type = unknown_arg_length; };
+		template<std::size_t L, std::size_t B, std::size_t A>
+		struct subtract<static_arg_length<L>, std::integral_constant<std::size_t, B>, std::integral_constant<std::size_t, A>> { using type = static_arg_length<L-B-A>; };
+		using type = function_sig<Dim, typename subtract<ArgLength, BeforeT, AfterT>::type, RetSig>;
+	};
+	template<class... RetSigs>
+	struct dim_replacement<dep_function_sig<Dim, RetSigs...>> {
+		static_assert(value_always_false<Dim>, "Cannot pad a tuple dimension");
+	};
+public:
+	using signature = typename T::signature::template replace<dim_replacement, Dim>;
+
+	template<class State>
+	constexpr auto sub_state(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		auto tmp_state = state.template remove<index_in<Dim>, length_in<Dim>>();
+		if constexpr(State::template contains<index_in<Dim>>)
+			if constexpr(State::template contains<length_in<Dim>>)
+				return tmp_state.template with<index_in<Dim>, length_in<Dim>>(state.template get<index_in<Dim>>() + before(), state.template get<length_in<Dim>>() + before() + after());
+			else
+				return tmp_state.template with<index_in<Dim>>(state.template get<index_in<Dim>>() + before());
+		else
+			if constexpr(State::template contains<length_in<Dim>>)
+				return tmp_state.template with<length_in<Dim>>(state.template get<length_in<Dim>>() + before() + after());
+			else
+				return tmp_state;
+	}
+
+	template<class State>
+	constexpr auto size(State state) const noexcept {
+		return sub_structure().size(sub_state(state));
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		return offset_of<Sub>(sub_structure(), sub_state(state));
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		if constexpr(QDim == Dim) {
+			static_assert(!State::template contains<index_in<Dim>>, "Index already set");
+			if constexpr(State::template contains<length_in<Dim>>) {
+				return state.template get<length_in<Dim>>();
+			} else {
+				return sub_structure().template length<Dim>(state.template remove<index_in<Dim>, length_in<Dim>>()) - before() - after();
+			}
+		} else {
+			return sub_structure().template length<QDim>(sub_state(state));
+		}
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_state_at(State state) const noexcept {
+		return state_at<Sub>(sub_structure(), sub_state(state));
+	}
+};
+
+template<char Dim, class BeforeT, class AfterT>
+struct pad_proto : contain<BeforeT, AfterT> {
+	using base = contain<BeforeT, AfterT>;
+	using base::base;
+
+	static constexpr bool proto_preserves_layout = true;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return pad_t<Dim, Struct, BeforeT, AfterT>(s, base::template get<0>(), base::template get<1>()); }
+};
+
+/**
+ * @brief adds `before` and `after` halo elements around each of the dimensions (see `pad_t`), the interior is the logical index space
+ *
+ * @tparam Dims: the padded dimensions
+ * @param before: the halo width before the interior (in each dimension)
+ * @param after: the halo width after the interior (in each dimension)
+ */
+template<char... Dims, class BeforeT, class AfterT>
+constexpr auto pad(BeforeT before, AfterT after) noexcept { return (... ^ pad_proto<Dims, good_index_t<BeforeT>, good_index_t<AfterT>>(before, after)); }
+
+namespace helpers {
+
+// the automatic padding of `pad_stride`
+struct auto_stride_pad {};
+
+// the cache line size assumed by the automatic padding
+constexpr std::size_t stride_pad_line = 64;
+
+} // namespace helpers
+
+/**
+ * @brief allocates more elements in a dimension than its length, to change the stride of the enclosing dimensions (the logical length does not change)
+ *
+ * When the size of a row is a power of two (in bytes), the elements of a column map to the same cache sets, which causes conflict misses when a column is traversed.
+ * The padding makes the row size a non-power-of-two: either `extra` more elements are allocated, or (for `helpers::auto_stride_pad`)
+ * the row size is rounded up to an odd number of cache lines (64 bytes), rows not larger than a cache line are not padded.
+ * The length has to be set after the padding (using `set_length`).
+ *
+ * @tparam Dim: the padded dimension (e.g. the inner dimension of a matrix)
+ * @tparam T: the sub-structure (the length in `Dim` must not be set)
+ * @tparam ExtraT: the type of the number of extra elements, or `helpers::auto_stride_pad`
+ */
+template<char Dim, class T, class ExtraT>
+struct stride_pad_t : contain<T, ExtraT> {
+	using base = contain<T, ExtraT>;
+	using base::base;
+
+	static constexpr char name[] = "stride_pad_t";
+	using params = struct_params<
+		dim_param<Dim>,
+		structure_param<T>,
+		type_param<ExtraT>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+	constexpr ExtraT extra() const noexcept { return base::template get<1>(); }
+
+private:
+	template<class Original>
+	struct dim_replacement;
+	template<class ArgLength, class RetSig>
+	struct dim_replacement<function_sig<Dim, ArgLength, RetSig>> {
+		static_assert(!ArgLength::is_known, "The length must be set after the padding (the padding changes the allocated length)");
+		using type = function_sig<Dim, ArgLength, RetSig>;
+	};
+	template<class... RetSigs>
+	struct dim_replacement<dep_function_sig<Dim, RetSigs...>> {
+		static_assert(value_always_false<Dim>, "Cannot pad a tuple dimension");
+	};
+public:
+	using signature = typename T::signature::template replace<dim_replacement, Dim>;
+
+	/**
+	 * @brief the number of elements allocated for the (logical) length `len`
+	 */
+	template<class LenT, class State>
+	constexpr auto physical_length(LenT len, State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		if constexpr(std::is_same_v<ExtraT, helpers::auto_stride_pad>) {
+			constexpr std::size_t line = helpers::stride_pad_line;
+			const std::size_t elem = sub_structure().size(state.template remove<index_in<Dim>, length_in<Dim>>().template with<length_in<Dim>>(lit<1>));
+			const std::size_t bytes = std::size_t(len) * elem;
+			if(bytes <= line)
+				return std::size_t(len);
+			std::size_t lines = (bytes + line - 1) / line;
+			if(lines % 2 == 0)
+				lines++;
+			return (lines * line + elem - 1) / elem;
+		} else {
+			return len + extra();
+		}
+	}
+
+	template<class State>
+	constexpr auto sub_state(State state) const noexcept {
+		if constexpr(State::template contains<length_in<Dim>>)
+			return state.template with<length_in<Dim>>(physical_length(state.template get<length_in<Dim>>(), state));
+		else
+			return state;
+	}
+
+	template<class State>
+	constexpr auto size(State state) const noexcept {
+		return sub_structure().size(sub_state(state));
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		return offset_of<Sub>(sub_structure(), sub_state(state));
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		if constexpr(QDim == Dim && State::template contains<length_in<Dim>>) {
+			static_assert(!State::template contains<index_in<Dim>>, "Index already set");
+			return state.template get<length_in<Dim>>();
+		} else {
+			return sub_structure().template length<QDim>(sub_state(state));
+		}
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_state_at(State state) const noexcept {
+		return state_at<Sub>(sub_structure(), sub_state(state));
+	}
+};
+
+template<char Dim, class ExtraT>
+struct stride_pad_proto : contain<ExtraT> {
+	using base = contain<ExtraT>;
+	using base::base;
+
+	static constexpr bool proto_preserves_layout = false;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return stride_pad_t<Dim, Struct, ExtraT>(s, base::template get<0>()); }
+};
+
+/**
+ * @brief allocates `extra` more elements in the dimension than its length, see `stride_pad_t`
+ */
+template<char Dim, class ExtraT>
+constexpr auto pad_stride(ExtraT extra) noexcept { return stride_pad_proto<Dim, good_index_t<ExtraT>>(extra); }
+
+/**
+ * @brief rounds the size of the dimension up to an odd number of cache lines, see `stride_pad_t`
+ */
+template<char Dim>
+constexpr auto pad_stride() noexcept { return stride_pad_proto<Dim, helpers::auto_stride_pad>(helpers::auto_stride_pad()); }
+
+namespace helpers {
+
+template<char Dim, class Struct>
+static constexpr bool is_pad_in = false;
+
+template<char Dim, class T, class BeforeT, class AfterT>
+static constexpr bool is_pad_in<Dim, pad_t<Dim, T, BeforeT, AfterT>> = true;
+
+// the halo widths of the pad_t in `Dim` (looks through the structures that wrap it, e.g. set_length_t)
+struct pad_extent {
+	std::size_t before;
+	std::size_t after;
+};
+
+template<char Dim, class Struct>
+constexpr pad_extent get_pad_extent(Struct s) noexcept {
+	if constexpr(is_pad_in<Dim, Struct>)
+		return {std::size_t(s.before()), std::size_t(s.after())};
+	else
+		return get_pad_extent<Dim>(s.sub_structure());
+}
+
+} // namespace helpers
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_PAD_HPP
@@ -1,6 +1,9 @@
 #ifndef NOARR_STRUCTURES_SCALAR_HPP
 #define NOARR_STRUCTURES_SCALAR_HPP
 
+#include <cstddef>
+#include <type_traits>
+
 #include "../base/contain.hpp"
 #include "../base/signature.hpp"
 #include "../base/state.hpp"
@@ -45,6 +48,83 @@ struct scalar : contain<> {
 	}
 };
 
+/**
+ * @brief the value type of a sub-byte scalar: an unsigned integer of `N` bits (see `scalar_bits`)
+ *
+ * The values are accessed through `bits_ref` proxies (returned by `get_at` and bags), never directly.
+ *
+ * @tparam N: the number of bits, 1, 2, or 4
+ */
+template<std::size_t N>
+struct bits {
+	static_assert(N == 1 || N == 2 || N == 4, "Only 1, 2, and 4 bit scalars are supported");
+	static constexpr std::size_t width = N;
+	static constexpr unsigned mask = (1u << N) - 1;
+
+	unsigned char storage;
+};
+
+/**
+ * @brief a scalar of `N` bits, it occupies a whole byte unless it is packed (see `bitpack`)
+ */
+template<std::size_t N>
+using scalar_bits = scalar<bits<N>>;
+
+/**
+ * @brief an offset of a value that does not start at a byte boundary (the offset of an element of a bit-packed structure)
+ */
+struct bit_offset {
+	std::size_t bytes;
+	std::size_t bit;
+
+	friend constexpr bit_offset operator+(std::size_t bytes, bit_offset offset) noexcept { return {bytes + offset.bytes, offset.bit}; }
+	friend constexpr bit_offset operator+(bit_offset offset, std::size_t bytes) noexcept { return {offset.bytes + bytes, offset.bit}; }
+	friend constexpr bool operator==(bit_offset a, bit_offset b) noexcept { return a.bytes == b.bytes && a.bit == b.bit; }
+	friend constexpr bool operator!=(bit_offset a, bit_offset b) noexcept { return !(a == b); }
+};
+
+/**
+ * @brief a reference to an `N`-bit value within a byte (a proxy, like `std::vector<bool>::reference`)
+ *
+ * Writing a value reads and writes the whole byte, so the neighboring values must not be written concurrently.
+ *
+ * @tparam N: the number of bits
+ * @tparam Byte: `unsigned char`, possibly cv-qualified
+ */
+template<std::size_t N, class Byte>
+class bits_ref {
+	Byte *byte_;
+	unsigned char shift_;
+
+public:
+	static constexpr unsigned mask = bits<N>::mask;
+
+	constexpr bits_ref(Byte *byte, std::size_t shift) noexcept : byte_(byte), shift_((unsigned char)shift) {}
+	constexpr bits_ref(const bits_ref &) noexcept = default;
+
+	constexpr operator unsigned() const noexcept { return (unsigned(*byte_) >> shift_) & mask; }
+
+	constexpr const bits_ref &operator=(unsigned value) const noexcept {
+		*byte_ = (unsigned char)((unsigned(*byte_) & ~(mask << shift_)) | ((value & mask) << shift_));
+		return *this;
+	}
+
+	constexpr const bits_ref &operator=(const bits_ref &other) const noexcept { return *this = unsigned(other); }
+
+	template<class OtherByte>
+	constexpr const bits_ref &operator=(const bits_ref<N, OtherByte> &other) const noexcept { return *this = unsigned(other); }
+};
+
+namespace helpers {
+
+template<class T>
+static constexpr bool is_bits = false;
+
+template<std::size_t N>
+static constexpr bool is_bits<bits<N>> = true;
+
+} // namespace helpers
+
 } // namespace noarr
 
 #endif // NOARR_STRUCTURES_SCALAR_HPP
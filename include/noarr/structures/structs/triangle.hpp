@@ -0,0 +1,236 @@
+#ifndef NOARR_STRUCTURES_TRIANGLE_HPP
+#define NOARR_STRUCTURES_TRIANGLE_HPP
+
+#include <cstddef>
+
+#include "../base/contain.hpp"
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../base/structs_common.hpp"
+#include "../base/utility.hpp"
+#include "../extra/shortcuts.hpp"
+
+namespace noarr {
+
+/**
+ * @brief a packed triangle of an `n` x `n` matrix: the index in `DimMinor` goes from zero to the index in `DimMajor` (inclusive if `Diagonal`)
+ *
+ * The lines (in `DimMajor`) are stored one after another, the line `m` starts at the element number `m * (m + 1) / 2` (`m * (m - 1) / 2` without the diagonal).
+ * The indices are the same as in the full matrix. A lower triangle stored by rows has `DimMajor` = the row dimension,
+ * an upper triangle stored by columns (the LAPACK packed upper layout) has `DimMajor` = the column dimension.
+ *
+ * @tparam DimMajor: the outer dimension
+ * @tparam DimMinor: the inner dimension, its length depends on the index in `DimMajor`
+ * @tparam T: the structure of one element (e.g. a scalar, or a dense block)
+ * @tparam Diagonal: whether the diagonal is stored
+ */
+template<char DimMajor, char DimMinor, class T, bool Diagonal>
+struct triangle_t : contain<T, std::size_t> {
+	using base = contain<T, std::size_t>;
+	using base::base;
+
+	static constexpr char name[] = "triangle_t";
+	using params = struct_params<
+		dim_param<DimMajor>,
+		dim_param<DimMinor>,
+		structure_param<T>,
+		value_param<bool, Diagonal>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+	constexpr std::size_t n() const noexcept { return base::template get<1>(); }
+
+	static_assert(DimMajor != DimMinor, "Dimension names must be different");
+	static_assert(!T::signature::template any_accept<DimMajor>, "Dimension name already used");
+	static_assert(!T::signature::template any_accept<DimMinor>, "Dimension name already used");
+	using signature = function_sig<DimMajor, dynamic_arg_length, function_sig<DimMinor, dynamic_arg_length, typename T::signature>>;
+
+	// the length of a line depends on the index in `DimMajor` (a traversal with full matrices takes the length from the triangle)
+	template<char QDim>
+	static constexpr bool dependent_length = QDim == DimMinor;
+
+	// the number of elements stored before the line `major`
+	static constexpr std::size_t line_start(std::size_t major) noexcept {
+		return Diagonal ? major * (major + 1) / 2 : major * (major - 1) / 2; // zero for major = 0 even though major - 1 wraps
+	}
+
+	template<class State>
+	constexpr auto sub_state(State state) const noexcept {
+		static_assert(!State::template contains<length_in<DimMajor>>, "Cannot set triangle length");
+		static_assert(!State::template contains<length_in<DimMinor>>, "Cannot set triangle length");
+		return state.template remove<index_in<DimMajor>, index_in<DimMinor>>();
+	}
+
+	template<class State>
+	constexpr std::size_t size(State state) const noexcept {
+		return line_start(n()) * sub_structure().size(sub_state(state));
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		static_assert(State::template contains<index_in<DimMajor>>, "All indices must be set");
+		static_assert(State::template contains<index_in<DimMinor>>, "All indices must be set");
+		std::size_t major = state.template get<index_in<DimMajor>>();
+		std::size_t minor = state.template get<index_in<DimMinor>>();
+		auto sub_struct = sub_structure();
+		auto sub_st = sub_state(state);
+		return (line_start(major) + minor) * sub_struct.size(sub_st) + offset_of<Sub>(sub_struct, sub_st);
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		if constexpr(QDim == DimMajor) {
+			static_assert(!State::template contains<index_in<DimMajor>>, "Index already set");
+			return n();
+		} else if constexpr(QDim == DimMinor) {
+			static_assert(!State::template contains<index_in<DimMinor>>, "Index already set");
+			static_assert(State::template contains<index_in<DimMajor>>, "The length of a line depends on the index in the major dimension, which has not been set yet");
+			std::size_t major = state.template get<index_in<DimMajor>>();
+			return Diagonal ? major + 1 : major;
+		} else {
+			return sub_structure().template length<QDim>(sub_state(state));
+		}
+	}
+
+	template<class Sub, class State>
+	constexpr void strict_state_at(State) const noexcept {
+		static_assert(value_always_false<DimMajor>, "A triangle_t cannot be used in this context");
+	}
+};
+
+template<char DimMajor, char DimMinor, bool Diagonal>
+struct triangle_proto : contain<std::size_t> {
+	using base = contain<std::size_t>;
+	using base::base;
+
+	static constexpr bool proto_preserves_layout = false;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return triangle_t<DimMajor, DimMinor, Struct, Diagonal>(s, base::template get<0>()); }
+};
+
+/**
+ * @brief the lower triangle of an `n` x `n` matrix (including the diagonal), stored by rows, see `triangle_t`
+ */
+template<char DimRow, char DimCol>
+constexpr auto lower_triangle(std::size_t n) noexcept { return triangle_proto<DimRow, DimCol, true>(n); }
+
+/**
+ * @brief the lower triangle of an `n` x `n` matrix without the diagonal, stored by rows, see `triangle_t`
+ */
+template<char DimRow, char DimCol>
+constexpr auto strict_lower_triangle(std::size_t n) noexcept { return triangle_proto<DimRow, DimCol, false>(n); }
+
+/**
+ * @brief the upper triangle of an `n` x `n` matrix (including the diagonal), stored by columns, see `triangle_t`
+ */
+template<char DimRow, char DimCol>
+constexpr auto upper_triangle(std::size_t n) noexcept { return triangle_proto<DimCol, DimRow, true>(n); }
+
+/**
+ * @brief the upper triangle of an `n` x `n` matrix without the diagonal, stored by columns, see `triangle_t`
+ */
+template<char DimRow, char DimCol>
+constexpr auto strict_upper_triangle(std::size_t n) noexcept { return triangle_proto<DimCol, DimRow, false>(n); }
+
+/**
+ * @brief a symmetric `n` x `n` matrix, only the lower triangle is stored (in the same layout as `lower_triangle`)
+ *
+ * Both dimensions have the length `n`, the element `(r, c)` is the same as the element `(c, r)`.
+ *
+ * @tparam DimRow, DimCol: the dimensions of the matrix
+ * @tparam T: the structure of one element
+ */
+template<char DimRow, char DimCol, class T>
+struct symmetric_t : contain<T, std::size_t> {
+	using base = contain<T, std::size_t>;
+	using base::base;
+
+	static constexpr char name[] = "symmetric_t";
+	using params = struct_params<
+		dim_param<DimRow>,
+		dim_param<DimCol>,
+		structure_param<T>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+	constexpr std::size_t n() const noexcept { return base::template get<1>(); }
+
+	static_assert(DimRow != DimCol, "Dimension names must be different");
+	static_assert(!T::signature::template any_accept<DimRow>, "Dimension name already used");
+	static_assert(!T::signature::template any_accept<DimCol>, "Dimension name already used");
+	using signature = function_sig<DimRow, dynamic_arg_length, function_sig<DimCol, dynamic_arg_length, typename T::signature>>;
+
+	template<class State>
+	constexpr auto sub_state(State state) const noexcept {
+		static_assert(!State::template contains<length_in<DimRow>>, "Cannot set symmetric matrix length");
+		static_assert(!State::template contains<length_in<DimCol>>, "Cannot set symmetric matrix length");
+		return state.template remove<index_in<DimRow>, index_in<DimCol>>();
+	}
+
+	template<class State>
+	constexpr std::size_t size(State state) const noexcept {
+		return n() * (n() + 1) / 2 * sub_structure().size(sub_state(state));
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		static_assert(State::template contains<index_in<DimRow>>, "All indices must be set");
+		static_assert(State::template contains<index_in<DimCol>>, "All indices must be set");
+		std::size_t row = state.template get<index_in<DimRow>>();
+		std::size_t col = state.template get<index_in<DimCol>>();
+		if(row < col) {
+			std::size_t tmp = row;
+			row = col;
+			col = tmp;
+		}
+		auto sub_struct = sub_structure();
+		auto sub_st = sub_state(state);
+		return (row * (row + 1) / 2 + col) * sub_struct.size(sub_st) + offset_of<Sub>(sub_struct, sub_st);
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		if constexpr(QDim == DimRow || QDim == DimCol) {
+			static_assert(!State::template contains<index_in<QDim>>, "Index already set");
+			return n();
+		} else {
+			return sub_structure().template length<QDim>(sub_state(state));
+		}
+	}
+
+	template<class Sub, class State>
+	constexpr void strict_state_at(State) const noexcept {
+		static_assert(value_always_false<DimRow>, "A symmetric_t cannot be used in this context");
+	}
+};
+
+template<char DimRow, char DimCol>
+struct symmetric_proto : contain<std::size_t> {
+	using base = contain<std::size_t>;
+	using base::base;
+
+	static constexpr bool proto_preserves_layout = false;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return symmetric_t<DimRow, DimCol, Struct>(s, base::template get<0>()); }
+};
+
+/**
+ * @brief a symmetric `n` x `n` matrix with only the lower triangle stored, see `symmetric_t`
+ */
+template<char DimRow, char DimCol>
+constexpr auto symmetric(std::size_t n) noexcept { return symmetric_proto<DimRow, DimCol>(n); }
+
+/**
+ * @brief the lower triangle of a matrix of `nblocks` x `nblocks` dense blocks of `Block` x `Block` elements (the diagonal blocks are stored whole)
+ *
+ * The blocks are stored as in `lower_triangle<DimBlockRow, DimBlockCol>`, each block is stored by rows.
+ * The element `(r, c)` of the matrix has the indices `r / Block`, `c / Block`, `r % Block`, `c % Block`.
+ */
+template<char DimBlockRow, char DimBlockCol, char DimRow, char DimCol, std::size_t Block>
+constexpr auto blocked_lower_triangle(std::size_t nblocks) noexcept {
+	return sized_vector<DimCol>(lit<Block>) ^ sized_vector<DimRow>(lit<Block>) ^ lower_triangle<DimBlockRow, DimBlockCol>(nblocks);
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_TRIANGLE_HPP
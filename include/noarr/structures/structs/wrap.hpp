@@ -0,0 +1,165 @@
+#ifndef NOARR_STRUCTURES_WRAP_HPP
+#define NOARR_STRUCTURES_WRAP_HPP
+
+#include <cstddef>
+
+#include "../base/contain.hpp"
+#include "../base/signature.hpp"
+#include "../base/state.hpp"
+#include "../base/structs_common.hpp"
+#include "../base/utility.hpp"
+#include "../extra/shortcuts.hpp"
+#include "../extra/to_struct.hpp"
+
+namespace noarr {
+
+/**
+ * @brief makes the index in a dimension wrap around: the (logical) index `i` refers to the index `i % length` in the sub-structure (the buffer)
+ *
+ * The logical length is unknown (any index can be used), it can be set using `set_length` (e.g. the number of time steps to traverse).
+ * The modulo is computed at compile time for static indices, it is a mask for a static power-of-two buffer length,
+ * and the buffer length can be a `fast_length` to avoid the division instruction in the other cases.
+ *
+ * @tparam Dim: the wrapped dimension
+ * @tparam T: the sub-structure (the length in `Dim` must be set)
+ */
+template<char Dim, class T>
+struct wrap_t : contain<T> {
+	using base = contain<T>;
+	using base::base;
+
+	static constexpr char name[] = "wrap_t";
+	using params = struct_params<
+		dim_param<Dim>,
+		structure_param<T>>;
+
+	constexpr T sub_structure() const noexcept { return base::template get<0>(); }
+
+private:
+	template<class Original>
+	struct dim_replacement;
+	template<class ArgLength, class RetSig>
+	struct dim_replacement<function_sig<Dim, ArgLength, RetSig>> {
+		static_assert(ArgLength::is_known, "The length of the buffer must be set before it is wrapped");
+		using type = function_sig<Dim, unknown_arg_length, RetSig>;
+	};
+	template<class... RetSigs>
+	struct dim_replacement<dep_function_sig<Dim, RetSigs...>> {
+		static_assert(value_always_false<Dim>, "Cannot wrap a tuple dimension");
+	};
+public:
+	using signature = typename T::signature::template replace<dim_replacement, Dim>;
+
+	/**
+	 * @brief the length of the buffer (the number of distinct positions in `Dim`)
+	 */
+	template<class State>
+	constexpr auto buffer_length(State state) const noexcept {
+		return sub_structure().template length<Dim>(state.template remove<index_in<Dim>, length_in<Dim>>());
+	}
+
+	template<class State>
+	constexpr auto sub_state(State state) const noexcept {
+		using namespace constexpr_arithmetic;
+		auto tmp_state = state.template remove<index_in<Dim>, length_in<Dim>>();
+		if constexpr(State::template contains<index_in<Dim>>)
+			return tmp_state.template with<index_in<Dim>>(state.template get<index_in<Dim>>() % buffer_length(tmp_state));
+		else
+			return tmp_state;
+	}
+
+	template<class State>
+	constexpr auto size(State state) const noexcept {
+		return sub_structure().size(sub_state(state));
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_offset_of(State state) const noexcept {
+		return offset_of<Sub>(sub_structure(), sub_state(state));
+	}
+
+	template<char QDim, class State>
+	constexpr auto length(State state) const noexcept {
+		if constexpr(QDim == Dim) {
+			static_assert(!State::template contains<index_in<Dim>>, "Index already set");
+			static_assert(State::template contains<length_in<Dim>>, "The logical length has not been set yet (use set_length)");
+			return state.template get<length_in<Dim>>();
+		} else {
+			return sub_structure().template length<QDim>(sub_state(state));
+		}
+	}
+
+	template<class Sub, class State>
+	constexpr auto strict_state_at(State state) const noexcept {
+		return state_at<Sub>(sub_structure(), sub_state(state));
+	}
+};
+
+template<char Dim>
+struct wrap_proto {
+	static constexpr bool proto_preserves_layout = true;
+
+	template<class Struct>
+	constexpr auto instantiate_and_construct(Struct s) const noexcept { return wrap_t<Dim, Struct>(s); }
+};
+
+/**
+ * @brief makes the index in the dimension wrap around the length of the structure, see `wrap_t`
+ *
+ * @tparam Dim: the wrapped dimension
+ */
+template<char Dim>
+constexpr auto wrap() noexcept { return wrap_proto<Dim>(); }
+
+/**
+ * @brief a ring buffer of `N` slots in `Dim` (used in place of `array<Dim, N>()`): the index `i` refers to the slot `i % N`
+ *
+ * @tparam Dim: the dimension name added by the structure
+ * @tparam N: the number of slots (preferably a power of two, e.g. 2 for a pair of time steps)
+ */
+template<char Dim, std::size_t N>
+constexpr auto ring() noexcept { return sized_vector<Dim>(lit<N>) ^ wrap<Dim>(); }
+
+namespace helpers {
+
+template<char Dim, class Struct>
+static constexpr bool is_wrap_in = false;
+
+template<char Dim, class T>
+static constexpr bool is_wrap_in<Dim, wrap_t<Dim, T>> = true;
+
+// look through the structures that wrap the wrap_t (e.g. set_length_t)
+template<char Dim, class Struct, class State>
+constexpr auto wrap_buffer_length(Struct s, State state) noexcept {
+	if constexpr(is_wrap_in<Dim, Struct>)
+		return s.buffer_length(state);
+	else
+		return wrap_buffer_length<Dim>(s.sub_structure(), state);
+}
+
+} // namespace helpers
+
+/**
+ * @brief calls `f(state, length)` for each run of the logical indices `first` to `first + count - 1` in `Dim` that does not wrap around the buffer
+ *
+ * `state` has the first logical index of the run, the following `length - 1` indices refer to the following positions of the buffer, with no wraparound.
+ * There are at most two runs if `count` does not exceed the buffer length.
+ *
+ * @param s: a structure (or a bag) with a `wrap` in `Dim` (the buffer length must not depend on the other indices)
+ * @param state: the indices in the other dimensions (if any)
+ */
+template<char Dim, class Struct, class F, class State = state<>>
+constexpr void wrap_for_each_run(const Struct &s, std::size_t first, std::size_t count, F f, State state = empty_state) {
+	const std::size_t buffer = helpers::wrap_buffer_length<Dim>(to_struct<Struct>::convert(s), state);
+	while(count > 0) {
+		const std::size_t room = buffer - first % buffer;
+		const std::size_t length = count < room ? count : room;
+		f(state.template with<index_in<Dim>>(first), length);
+		first += length;
+		count -= length;
+	}
+}
+
+} // namespace noarr
+
+#endif // NOARR_STRUCTURES_WRAP_HPP
@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/structs/aosoa.hpp>
+
+using noarr::lit;
+
+TEST_CASE("AoSoA offsets", "[aosoa]") {
+	auto record = noarr::make_tuple<'f'>(noarr::scalar<float>(), noarr::scalar<double>(), noarr::scalar<std::int16_t>());
+	auto s = record ^ noarr::aosoa<'i', 4>() ^ noarr::set_length<'i'>(10);
+	constexpr std::size_t record_size = sizeof(float) + sizeof(double) + sizeof(std::int16_t);
+
+	REQUIRE((s | noarr::get_length<'i'>()) == 10);
+	REQUIRE((s | noarr::get_length<'f'>()) == 3);
+	REQUIRE((s | noarr::get_size()) == 3 * 4 * record_size); // the last chunk is padded
+	REQUIRE(noarr::aosoa_width<'i', decltype(s)> == 4);
+
+	// the chunk of 4 records: 4 floats, 4 doubles, 4 shorts
+	REQUIRE((s | noarr::offset<'i', 'f'>(0, lit<0>)) == 0);
+	REQUIRE((s | noarr::offset<'i', 'f'>(3, lit<0>)) == 3 * sizeof(float));
+	REQUIRE((s | noarr::offset<'i', 'f'>(2, lit<1>)) == 4 * sizeof(float) + 2 * sizeof(double));
+	REQUIRE((s | noarr::offset<'i', 'f'>(1, lit<2>)) == 4 * sizeof(float) + 4 * sizeof(double) + sizeof(std::int16_t));
+	REQUIRE((s | noarr::offset<'i', 'f'>(9, lit<1>)) == 2 * 4 * record_size + 4 * sizeof(float) + sizeof(double));
+
+	// all the elements are distinct and inside the structure
+	std::vector<bool> used(s | noarr::get_size());
+	noarr::traverser(s).for_each([&](auto state) {
+		std::size_t off = s | noarr::offset(state);
+		REQUIRE(off < used.size());
+		REQUIRE(!used[off]);
+		used[off] = true;
+	});
+}
+
+TEST_CASE("AoSoA chunks", "[aosoa]") {
+	auto record = noarr::make_tuple<'f'>(noarr::scalar<float>(), noarr::scalar<float>());
+	auto particles = noarr::make_bag(record ^ noarr::aosoa<'i', 8>() ^ noarr::set_length<'i'>(21));
+
+	noarr::traverser(particles).for_each([&](auto state) {
+		particles[state] = float(noarr::get_index<'i'>(state) * 10 + noarr::get_index<'f'>(state));
+	});
+
+	std::size_t num_chunks = 0, num_records = 0;
+	noarr::aosoa_for_each_chunk<'i'>(particles, [&](auto state, auto lanes) {
+		const float *x = &particles[state.template with<noarr::index_in<'f'>>(lit<0>)];
+		const float *y = &particles[state.template with<noarr::index_in<'f'>>(lit<1>)];
+		const std::size_t first = noarr::get_index<'i'>(state);
+		REQUIRE(first == num_chunks * 8);
+		for(std::size_t l = 0; l < lanes; l++) {
+			REQUIRE(x[l] == float((first + l) * 10));
+			REQUIRE(y[l] == float((first + l) * 10 + 1));
+		}
+		num_chunks++;
+		num_records += lanes;
+	});
+
+	REQUIRE(num_chunks == 3);
+	REQUIRE(num_records == 21);
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+
+// the asynchronous I/O uses POSIX file descriptors
+#ifndef _WIN32
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/async_io.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#ifdef __linux__
+#include <noarr/structures/interop/io_uring.hpp>
+#endif
+
+template<class Backend>
+static void test_async_blocks() {
+	std::FILE *file = std::tmpfile();
+	REQUIRE(file != nullptr);
+	const int fd = fileno(file);
+
+	auto block = noarr::scalar<int>() ^ noarr::sized_vector<'j'>(1000) ^ noarr::sized_vector<'i'>(3);
+	noarr::async_block_file<'k', decltype(block), Backend> blocks(fd, 8, block, 10, 3);
+	REQUIRE(blocks.good());
+	REQUIRE((blocks.structure() | noarr::get_length<'k'>()) == 10);
+
+	REQUIRE(blocks.write_blocks([](auto state, auto &bag) {
+		noarr::traverser(bag).for_each([&](auto inner) {
+			bag[inner] = int(noarr::get_index<'k'>(state) * 10000 + noarr::get_index<'i'>(inner) * 1000 + noarr::get_index<'j'>(inner));
+		});
+	}));
+
+	// the file contains the memory image of the whole structure
+	auto whole = noarr::make_bag(blocks.structure());
+	REQUIRE(noarr::pread_data(fd, 8, whole, 1));
+	REQUIRE(whole.template at<'k', 'i', 'j'>(7, 2, 345) == 72345);
+
+	std::size_t visited = 0;
+	long long sum = 0;
+	REQUIRE(blocks.for_each_block([&](auto state, auto &bag) {
+		REQUIRE(noarr::get_index<'k'>(state) == visited++);
+		noarr::traverser(bag).for_each([&](auto inner) {
+			sum += bag[inner];
+		});
+	}));
+	REQUIRE(visited == 10);
+	REQUIRE(sum == 3000 * 45 * 10000LL + 10 * 1000 * 3 * 1000LL + 10 * 3 * 499500LL);
+
+	// the file is too short for more blocks
+	noarr::async_block_file<'k', decltype(block), Backend> more(fd, 8, block, 12, 2);
+	visited = 0;
+	REQUIRE(!more.for_each_block([&](auto, auto &) { visited++; }));
+	REQUIRE(visited == 10);
+
+	std::fclose(file);
+}
+
+TEST_CASE("Async blocks with threads", "[async_io]") {
+	test_async_blocks<noarr::thread_io_backend>();
+}
+
+#ifdef __linux__
+TEST_CASE("Async blocks with io_uring", "[async_io]") {
+	test_async_blocks<noarr::io_uring_backend>();
+}
+#endif
+
+// fails the `FailAt`-th submission and counts the submitted requests that have not been waited for
+template<std::size_t FailAt>
+struct failing_io_backend {
+	noarr::thread_io_backend backend;
+	std::size_t submissions = 0;
+	std::size_t outstanding = 0;
+
+	bool init(char *buffers, std::size_t buffer_size, std::size_t num_buffers, std::size_t queue_depth) {
+		return backend.init(buffers, buffer_size, num_buffers, queue_depth);
+	}
+
+	bool submit(const noarr::io_request &request) {
+		if(submissions++ == FailAt)
+			return false;
+		outstanding++;
+		return backend.submit(request);
+	}
+
+	bool wait(std::size_t buffer) {
+		outstanding--;
+		return backend.wait(buffer);
+	}
+};
+
+template<std::size_t FailAt>
+static void test_failed_submission(int fd) {
+	auto block = noarr::scalar<int>() ^ noarr::sized_vector<'j'>(100);
+
+	noarr::async_block_file<'k', decltype(block), failing_io_backend<FailAt>> reader(fd, 0, block, 10, 3);
+	std::size_t visited = 0;
+	REQUIRE(!reader.for_each_block([&](auto, auto &) { visited++; }));
+	REQUIRE(visited <= FailAt);
+	REQUIRE(reader.backend().outstanding == 0);
+
+	noarr::async_block_file<'k', decltype(block), failing_io_backend<FailAt>> writer(fd, 0, block, 10, 3);
+	REQUIRE(!writer.write_blocks([](auto, auto &bag) { noarr::traverser(bag).for_each([&](auto state) { bag[state] = 1; }); }));
+	REQUIRE(writer.backend().outstanding == 0);
+}
+
+TEST_CASE("Async blocks with a failed submission", "[async_io]") {
+	std::FILE *file = std::tmpfile();
+	REQUIRE(file != nullptr);
+	const int fd = fileno(file);
+
+	auto block = noarr::scalar<int>() ^ noarr::sized_vector<'j'>(100);
+	noarr::async_block_file<'k', decltype(block)> blocks(fd, 0, block, 10, 3);
+	REQUIRE(blocks.write_blocks([](auto, auto &bag) { noarr::traverser(bag).for_each([&](auto state) { bag[state] = 1; }); }));
+
+	// every submitted request is waited for before returning (its buffer may be reused by the next call)
+	test_failed_submission<0>(fd);
+	test_failed_submission<1>(fd);
+	test_failed_submission<2>(fd);
+	test_failed_submission<6>(fd);
+
+	std::fclose(file);
+}
+
+#endif // _WIN32
@@ -0,0 +1,99 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/structs/bitpack.hpp>
+
+using noarr::lit;
+
+TEST_CASE("Bitpack offsets and access", "[bitpack]") {
+	auto mask = noarr::scalar_bits<1>() ^ noarr::bitpack<'i'>() ^ noarr::set_length<'i'>(1000);
+	auto quant = noarr::scalar_bits<4>() ^ noarr::bitpack<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(3, 10);
+
+	REQUIRE((mask | noarr::get_size()) == 128); // 1000 bits in 16 words
+	REQUIRE((quant | noarr::get_size()) == 3 * 8); // each row in one word
+	REQUIRE((mask | noarr::offset<'i'>(13)) == noarr::bit_offset{1, 5});
+	REQUIRE((quant | noarr::offset<'i', 'j'>(2, 5)) == noarr::bit_offset{2 * 8 + 2, 4});
+
+	auto bits = noarr::make_bag(mask);
+	auto nibbles = noarr::make_bag(quant);
+
+	noarr::traverser(bits).for_each([&](auto state) {
+		bits[state] = noarr::get_index<'i'>(state) % 3 == 0;
+	});
+	noarr::traverser(nibbles).for_each([&](auto state) {
+		nibbles[state] = unsigned(noarr::get_index<'i'>(state) * 10 + noarr::get_index<'j'>(state)) % 16;
+	});
+
+	noarr::traverser(bits).for_each([&](auto state) {
+		REQUIRE(bits[state] == (noarr::get_index<'i'>(state) % 3 == 0));
+	});
+	noarr::traverser(nibbles).for_each([&](auto state) {
+		REQUIRE(nibbles[state] == unsigned(noarr::get_index<'i'>(state) * 10 + noarr::get_index<'j'>(state)) % 16);
+	});
+	REQUIRE(nibbles.at<'i', 'j'>(1, 7) == 1);
+
+	nibbles.at<'i', 'j'>(1, 7) = nibbles.at<'i', 'j'>(2, 9);
+	REQUIRE(nibbles.at<'i', 'j'>(1, 7) == 13);
+	REQUIRE(nibbles.at<'i', 'j'>(1, 6) == 0);
+	REQUIRE(nibbles.at<'i', 'j'>(1, 8) == 2);
+
+	// an unpacked sub-byte scalar occupies a whole byte
+	auto bytes = noarr::make_bag(noarr::scalar_bits<2>() ^ noarr::sized_vector<'i'>(10));
+	REQUIRE((bytes | noarr::get_size()) == 10);
+	bytes.at<'i'>(4) = 7;
+	REQUIRE(bytes.at<'i'>(4) == 3);
+}
+
+TEST_CASE("Bitpack word operations", "[bitpack]") {
+	auto s = noarr::scalar_bits<1>() ^ noarr::bitpack<'i'>() ^ noarr::set_length<'i'>(200);
+	auto a = noarr::make_bag(s);
+	auto b = noarr::make_bag(s);
+	auto c = noarr::make_bag(s);
+
+	for(std::size_t i = 0; i < 200; i++) {
+		a.at<'i'>(i) = i % 2 == 0;
+		b.at<'i'>(i) = i % 3 == 0;
+	}
+	REQUIRE(noarr::bitpack_popcount<'i'>(a) == 100);
+	REQUIRE(noarr::bitpack_popcount<'i'>(b) == 67);
+
+	// the bits past the length must not be counted or overwritten
+	const std::size_t size = s | noarr::get_size();
+	a.data()[size - 1] = (char)0xFF;
+	REQUIRE(noarr::bitpack_popcount<'i'>(a) == 100);
+	c.data()[size - 1] = (char)0x80;
+	noarr::bitpack_transform<'i'>([](std::uint64_t x, std::uint64_t y) { return x & ~y; }, c, a, b);
+	REQUIRE(c.data()[size - 1] == (char)0x80);
+	for(std::size_t i = 0; i < 200; i++)
+		REQUIRE(c.at<'i'>(i) == (i % 2 == 0 && i % 3 != 0));
+	REQUIRE(noarr::bitpack_popcount<'i'>(c) == 66);
+
+	// the rows of a matrix are processed by fixing the other dimension
+	auto m = noarr::make_bag(noarr::scalar_bits<1>() ^ noarr::bitpack<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(4, 70));
+	m.at<'i', 'j'>(2, 69) = 1;
+	m.at<'i', 'j'>(3, 0) = 1;
+	auto row = noarr::make_bag(m.structure() ^ noarr::fix<'i'>(2), m.data());
+	REQUIRE(noarr::bitpack_popcount<'j'>(row) == 1);
+}
+
+TEST_CASE("Bitpack pack and unpack", "[bitpack]") {
+	for(std::size_t length : {0, 1, 7, 8, 9, 100}) {
+		auto packed = noarr::make_bag(noarr::scalar_bits<2>() ^ noarr::bitpack<'i'>() ^ noarr::set_length<'i'>(length));
+		std::vector<std::uint8_t> values(length), unpacked(length);
+		for(std::size_t i = 0; i < length; i++)
+			values[i] = std::uint8_t(i * 7 % 4);
+
+		noarr::bitpack_pack<'i'>(packed, values.data());
+		for(std::size_t i = 0; i < length; i++)
+			REQUIRE(packed.at<'i'>(i) == values[i]);
+
+		noarr::bitpack_unpack<'i'>(packed, unpacked.data());
+		REQUIRE(unpacked == values);
+	}
+}
@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/interop/chunked.hpp>
+#include <noarr/structures/interop/codec.hpp>
+
+TEST_CASE("LZ4 codec", "[chunked]") {
+	noarr::lz4_codec codec;
+
+	std::vector<char> inputs[3];
+	for(int i = 0; i < 1000; i++)
+		inputs[0].push_back("abcabcabd"[i % 9]);
+	for(unsigned i = 0, x = 1; i < 1000; i++, x = x * 1103515245 + 12345)
+		inputs[1].push_back(char(x >> 16));
+	inputs[2] = {'x', 'y', 'z'};
+
+	for(const auto &input : inputs) {
+		std::vector<char> encoded(codec.max_encoded_size(input.size()));
+		encoded.resize(codec.encode(input.data(), input.size(), encoded.data()));
+
+		std::vector<char> decoded(input.size());
+		REQUIRE(codec.decode(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+		REQUIRE(decoded == input);
+
+		// truncated input or a wrong size
+		REQUIRE(!codec.decode(encoded.data(), encoded.size() - 1, decoded.data(), decoded.size()));
+		REQUIRE(!codec.decode(encoded.data(), encoded.size(), decoded.data(), decoded.size() - 1));
+	}
+
+	std::vector<char> encoded(codec.max_encoded_size(inputs[0].size()));
+	REQUIRE(codec.encode(inputs[0].data(), inputs[0].size(), encoded.data()) < 100);
+}
+
+TEST_CASE("Chunked array", "[chunked]") {
+	auto s = noarr::scalar<int>() ^ noarr::sized_vector<'j'>(12) ^ noarr::sized_vector<'i'>(10)
+		^ noarr::into_blocks<'i', 'I', 'i'>(5) ^ noarr::into_blocks<'j', 'J', 'j'>(4);
+	auto layout = noarr::chunk_layout<'I', 'J'>(s);
+
+	REQUIRE(layout.num_chunks() == 2 * 3);
+	REQUIRE(layout.chunk_size() == 5 * 4 * sizeof(int));
+	REQUIRE((layout.chunk_structure() | noarr::get_length<'i'>()) == 5);
+	REQUIRE((layout.chunk_structure() | noarr::get_length<'j'>()) == 4);
+	REQUIRE(layout.chunk_number(noarr::idx<'I', 'J', 'i'>(1, 2, 3)) == 5);
+
+	auto bag = noarr::make_bag(s);
+	noarr::traverser(bag).for_each([&](auto state) {
+		bag[state] = int(noarr::get_index<'I'>(state) * 1000 + noarr::get_index<'J'>(state) * 100 + noarr::get_index<'i'>(state) * 10 + noarr::get_index<'j'>(state));
+	});
+
+	std::stringstream file;
+	REQUIRE(noarr::write_chunked(file, layout, bag.data()));
+
+	noarr::chunked_reader reader(layout, file);
+	REQUIRE(reader.good());
+	auto index = reader.index();
+	REQUIRE((index.template at<'I', 'J'>(0, 0)).offset == noarr::helpers::chunked_header_size + 6 * sizeof(noarr::chunk_entry));
+	REQUIRE((index.template at<'I', 'J'>(0, 1)).offset == (index.template at<'I', 'J'>(0, 0)).offset + (index.template at<'I', 'J'>(0, 0)).size);
+
+	auto copy = noarr::make_bag(s);
+	REQUIRE(reader.decode_all(copy.data()));
+	noarr::traverser(bag).for_each([&](auto state) {
+		REQUIRE(copy[state] == bag[state]);
+	});
+
+	noarr::chunked_bag view(reader, 2);
+	noarr::traverser(bag).order(noarr::hoist<'J'>()).for_each([&](auto state) {
+		REQUIRE(view[state] == bag[state]);
+	});
+	REQUIRE(view.template at<'I', 'J', 'i', 'j'>(1, 2, 3, 1) == 1231);
+	REQUIRE(view.cache_misses() == 6);
+
+	auto [chunk, owner] = view.chunk(noarr::idx<'I', 'J'>(1, 1));
+	REQUIRE(owner);
+	REQUIRE((chunk.template at<'i', 'j'>(4, 3)) == 1143);
+
+	// a different layout or codec does not match the header
+	file.clear();
+	file.seekg(0);
+	noarr::chunked_reader<decltype(layout), noarr::raw_codec> raw_reader(layout, file);
+	REQUIRE(!raw_reader.good());
+	file.clear();
+	file.seekg(0);
+	noarr::chunked_reader other_reader(noarr::chunk_layout<'I'>(s), file);
+	REQUIRE(!other_reader.good());
+}
+
+TEST_CASE("Chunked array encoded by chunks", "[chunked]") {
+	auto s = noarr::scalar<float>() ^ noarr::sized_vector<'i'>(64) ^ noarr::into_blocks<'i', 'I', 'i'>(16);
+	auto layout = noarr::chunk_layout<'I'>(s);
+
+	std::vector<float> data(64, 0.5f);
+	noarr::chunked_encoder<decltype(layout), noarr::raw_codec> encoder(layout);
+	noarr::traverser(layout.grid()).for_each([&](auto chunk_state) {
+		encoder.encode(chunk_state, data.data());
+	});
+
+	std::stringstream file;
+	REQUIRE(encoder.write(file));
+	REQUIRE(file.str().size() == noarr::helpers::chunked_header_size + 4 * sizeof(noarr::chunk_entry) + 64 * sizeof(float));
+
+	// corrupt the last chunk
+	std::string contents = file.str();
+	contents.pop_back();
+	std::stringstream corrupt(contents);
+	noarr::chunked_reader<decltype(layout), noarr::raw_codec> reader(layout, corrupt);
+	REQUIRE(reader.good());
+
+	std::vector<float> copy(64);
+	REQUIRE(reader.decode(noarr::idx<'I'>(0), copy.data()));
+	REQUIRE(!reader.decode(noarr::idx<'I'>(3), copy.data()));
+	REQUIRE(!reader.decode_all(copy.data()));
+	REQUIRE(copy[15] == 0.5f);
+
+	noarr::chunked_bag view(reader, 1);
+	REQUIRE(view.template at<'I', 'i'>(2, 0) == 0.5f);
+	REQUIRE(view.template at<'I', 'i'>(3, 0) == 0.0f);
+	REQUIRE(!view.chunk(noarr::idx<'I'>(3)).second);
+}
+
+TEST_CASE("Chunked array with a corrupted index", "[chunked]") {
+	auto s = noarr::scalar<float>() ^ noarr::sized_vector<'i'>(64) ^ noarr::into_blocks<'i', 'I', 'i'>(16);
+	auto layout = noarr::chunk_layout<'I'>(s);
+
+	std::vector<float> data(64, 0.5f);
+	std::stringstream file;
+	REQUIRE(noarr::write_chunked(file, layout, data.data()));
+
+	// a huge size in the index entry of the second chunk
+	std::string contents = file.str();
+	const std::uint64_t huge_size = std::uint64_t(1) << 62;
+	std::memcpy(&contents[noarr::helpers::chunked_header_size + sizeof(noarr::chunk_entry) + offsetof(noarr::chunk_entry, size)], &huge_size, sizeof(huge_size));
+	std::stringstream corrupt(contents);
+	noarr::chunked_reader<decltype(layout)> reader(layout, corrupt);
+	REQUIRE(reader.good());
+
+	std::vector<char> chunk(layout.chunk_size());
+	REQUIRE(reader.read_chunk(0, chunk.data()));
+	REQUIRE(!reader.read_chunk(1, chunk.data()));
+	REQUIRE(reader.read_chunk(2, chunk.data()));
+
+	std::vector<float> copy(64);
+	REQUIRE(!reader.decode_all(copy.data()));
+	REQUIRE(copy[0] == 0.5f);
+	REQUIRE(copy[16] == 0.0f);
+	REQUIRE(copy[32] == 0.5f);
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/structs/csr.hpp>
+#include <noarr/structures/interop/bag.hpp>
+
+TEST_CASE("CSR layout", "[csr]") {
+	// rows of lengths 2, 0, 3, 1
+	const std::size_t row_ptr[] = {0, 2, 2, 5, 6};
+	auto s = noarr::scalar<float>() ^ noarr::csr<'i', 'j'>(row_ptr, 4);
+
+	REQUIRE((s | noarr::get_size()) == 6 * sizeof(float));
+	REQUIRE((s | noarr::get_length<'i'>()) == 4);
+	REQUIRE((s | noarr::get_length<'j'>(noarr::idx<'i'>(0))) == 2);
+	REQUIRE((s | noarr::get_length<'j'>(noarr::idx<'i'>(1))) == 0);
+	REQUIRE((s | noarr::get_length<'j'>(noarr::idx<'i'>(2))) == 3);
+	REQUIRE((s | noarr::offset<'i', 'j'>(2, 1)) == 3 * sizeof(float));
+	REQUIRE((s | noarr::offset<'i', 'j'>(3, 0)) == 5 * sizeof(float));
+
+	std::vector<std::size_t> visited;
+	noarr::traverser(s).for_each([&](auto state) {
+		auto [i, j] = noarr::get_indices<'i', 'j'>(state);
+		REQUIRE(j < row_ptr[i + 1] - row_ptr[i]);
+		visited.push_back(s | noarr::offset(state));
+	});
+
+	REQUIRE(visited.size() == 6);
+	for(std::size_t k = 0; k < 6; k++)
+		REQUIRE(visited[k] == k * sizeof(float));
+}
+
+TEST_CASE("CSR of tuples", "[csr]") {
+	const std::uint32_t row_ptr[] = {0, 1, 4};
+	auto s = noarr::make_tuple<'t'>(noarr::scalar<double>(), noarr::scalar<std::int32_t>()) ^ noarr::csr<'i', 'j'>(row_ptr, 2);
+
+	REQUIRE((s | noarr::get_size()) == 4 * (sizeof(double) + sizeof(std::int32_t)));
+	REQUIRE((s | noarr::offset<'i', 'j', 't'>(1, 2, noarr::lit<1>)) == 3 * (sizeof(double) + sizeof(std::int32_t)) + sizeof(double));
+
+	std::size_t count = 0;
+	noarr::traverser(s).for_each([&](auto) { count++; });
+	REQUIRE(count == 2 * 4);
+}
+
+TEST_CASE("CSR sparse matrix-vector product", "[csr]") {
+	const std::size_t n = 5;
+	const float dense[n][n] = {
+		{1, 0, 0, 2, 0},
+		{0, 0, 0, 0, 0},
+		{0, 3, 4, 0, 5},
+		{6, 0, 0, 0, 0},
+		{0, 0, 7, 0, 8},
+	};
+
+	std::vector<std::size_t> row_ptr = {0};
+	std::vector<float> values_data;
+	std::vector<std::size_t> cols_data;
+	for(std::size_t i = 0; i < n; i++) {
+		for(std::size_t j = 0; j < n; j++) {
+			if(dense[i][j] != 0) {
+				values_data.push_back(dense[i][j]);
+				cols_data.push_back(j);
+			}
+		}
+		row_ptr.push_back(values_data.size());
+	}
+
+	auto csr = noarr::csr<'i', 'j'>(row_ptr.data(), n);
+	auto values = noarr::make_bag(noarr::scalar<float>() ^ csr, values_data.data());
+	auto cols = noarr::make_bag(noarr::scalar<std::size_t>() ^ csr, cols_data.data());
+	auto x = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vector<'c'>(n));
+	auto y = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vector<'i'>(n));
+
+	noarr::traverser(x).for_each([&](auto state) { x[state] = float(noarr::get_index<'c'>(state) + 1); });
+
+	noarr::traverser(values, cols, y).for_each([&](auto state) {
+		y[state] += values[state] * x[noarr::idx<'c'>(cols[state])];
+	});
+
+	for(std::size_t i = 0; i < n; i++) {
+		float expected = 0;
+		for(std::size_t j = 0; j < n; j++)
+			expected += dense[i][j] * float(j + 1);
+		REQUIRE(y.at<'i'>(i) == expected);
+	}
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/structs/slice.hpp>
+#include <noarr/structures/structs/zcurve.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/interop/dlpack.hpp>
+
+TEST_CASE("DLPack export", "[dlpack]") {
+	std::vector<float> data(20 * 30);
+	auto s = noarr::scalar<float>() ^ noarr::sized_vector<'j'>(30) ^ noarr::sized_vector<'i'>(20) ^ noarr::slice<'j'>(5, 10) ^ noarr::step<'i'>(1, 3) ^ noarr::reverse<'j'>();
+
+	auto exported = noarr::to_dlpack(s, data.data());
+	REQUIRE(exported);
+	const noarr::dl_tensor &t = exported->tensor();
+
+	REQUIRE(t.data == data.data());
+	REQUIRE(t.device.device_type == noarr::dl_cpu);
+	REQUIRE(t.dtype.code == noarr::dl_float);
+	REQUIRE(t.dtype.bits == 32);
+	REQUIRE(t.dtype.lanes == 1);
+	REQUIRE(t.ndim == 2);
+	REQUIRE(t.shape[0] == 7);
+	REQUIRE(t.shape[1] == 10);
+	REQUIRE(t.strides[0] == 3 * 30);
+	REQUIRE(t.strides[1] == -1);
+
+	noarr::traverser(s).for_each([&](auto state) {
+		std::int64_t element = std::int64_t(t.byte_offset / sizeof(float)) + t.strides[0] * std::int64_t(noarr::get_index<'i'>(state)) + t.strides[1] * std::int64_t(noarr::get_index<'j'>(state));
+		REQUIRE(element * std::int64_t(sizeof(float)) == std::int64_t(s | noarr::offset(state)));
+	});
+
+	noarr::dl_managed_tensor *managed = std::move(*exported).release();
+	REQUIRE(managed->tensor.shape[1] == 10);
+	managed->deleter(managed);
+
+	auto a = noarr::array<'y', 4, noarr::array<'x', 4, noarr::scalar<int>>>();
+	REQUIRE(noarr::to_dlpack(a, data.data()));
+	REQUIRE(!noarr::to_dlpack(a ^ noarr::merge_zcurve<'y', 'x', 'z'>::maxlen_alignment<4, 2>(), data.data()));
+}
+
+TEST_CASE("DLPack import", "[dlpack]") {
+	std::vector<double> data(4 * 5 * 6);
+	for(std::size_t k = 0; k < data.size(); k++)
+		data[k] = double(k);
+
+	// a C-contiguous 4x5x6 array sliced as `[1:, ::2, :]`
+	std::int64_t shape[] = {3, 3, 6};
+	std::int64_t strides[] = {30, 12, 1};
+	noarr::dl_tensor t{data.data(), {noarr::dl_cpu, 0}, 3, noarr::dl_data_type_of<double>(), shape, strides, 30 * sizeof(double)};
+
+	auto bag = noarr::from_dlpack<double, 'i', 'j', 'k'>(t);
+	REQUIRE(bag);
+	REQUIRE((bag->template get_length<'i'>()) == 3);
+	REQUIRE((bag->template get_length<'j'>()) == 3);
+	REQUIRE((bag->template get_length<'k'>()) == 6);
+	noarr::traverser(*bag).for_each([&](auto state) {
+		auto i = noarr::get_index<'i'>(state), j = noarr::get_index<'j'>(state), k = noarr::get_index<'k'>(state);
+		REQUIRE((*bag)[state] == double(30 + i * 30 + j * 12 + k));
+	});
+
+	REQUIRE(!noarr::from_dlpack<float, 'i', 'j', 'k'>(t));
+	REQUIRE(!noarr::from_dlpack<double, 'i', 'j'>(t));
+
+	// compact (no strides)
+	t.strides = nullptr;
+	t.byte_offset = 0;
+	auto dense = noarr::from_dlpack<double, 'i', 'j', 'k'>(t);
+	REQUIRE(dense);
+	REQUIRE((dense->template at<'i', 'j', 'k'>(2, 1, 3)) == double(2 * 18 + 1 * 6 + 3));
+
+	// transposed and broadcast
+	std::int64_t transposed[] = {1, 4, 20};
+	t.strides = transposed;
+	REQUIRE(!noarr::from_dlpack<double, 'i', 'j', 'k'>(t));
+	std::int64_t broadcast[] = {0, 6, 1};
+	t.strides = broadcast;
+	REQUIRE(!noarr::from_dlpack<double, 'i', 'j', 'k'>(t));
+}
+
+TEST_CASE("DLPack import with negative strides", "[dlpack]") {
+	std::vector<int> data(5 * 5);
+	for(std::size_t k = 0; k < data.size(); k++)
+		data[k] = int(k);
+
+	// a C-contiguous 5x5 array sliced as `[::-2, 1:4]`
+	std::int64_t shape[] = {3, 3};
+	std::int64_t strides[] = {-10, 1};
+	noarr::dl_tensor t{data.data(), {noarr::dl_cpu, 0}, 2, noarr::dl_data_type_of<int>(), shape, strides, (20 + 1) * sizeof(int)};
+
+	REQUIRE(!noarr::from_dlpack<int, 'i', 'j'>(t));
+
+	int calls = 0;
+	REQUIRE(noarr::with_dlpack<int, 'i', 'j'>(t, [&](auto bag) {
+		calls++;
+		noarr::traverser(bag).for_each([&](auto state) {
+			auto i = int(noarr::get_index<'i'>(state)), j = int(noarr::get_index<'j'>(state));
+			REQUIRE(bag[state] == 21 - 10 * i + j);
+		});
+	}));
+	REQUIRE(calls == 1);
+
+	// the exported descriptor of the imported bag describes the same elements
+	noarr::with_dlpack<int, 'i', 'j'>(t, [&](auto bag) {
+		auto exported = noarr::to_dlpack(bag.structure(), bag.data());
+		REQUIRE(exported);
+		const noarr::dl_tensor &e = exported->tensor();
+		REQUIRE(e.strides[0] == -10);
+		REQUIRE(e.strides[1] == 1);
+		REQUIRE(static_cast<char *>(e.data) + e.byte_offset == static_cast<char *>(t.data) + t.byte_offset);
+	});
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/interop/dynamic_struct.hpp>
+#include <noarr/structures/structs/zcurve.hpp>
+
+TEST_CASE("Dynamic struct from a static structure", "[dynamic_struct]") {
+	auto s = noarr::scalar<float>() ^ noarr::sized_vector<'j'>(30) ^ noarr::sized_vector<'i'>(20);
+	auto maybe_ds = noarr::to_dynamic_struct(s);
+	REQUIRE(maybe_ds);
+	const noarr::dynamic_struct &ds = *maybe_ds;
+
+	REQUIRE(ds.elem_size() == sizeof(float));
+	REQUIRE(ds.rank() == 2);
+	REQUIRE(ds.dim(0).name == 'i');
+	REQUIRE(ds.dim(0).length == 20);
+	REQUIRE(ds.dim(0).stride == 30 * sizeof(float));
+	REQUIRE(ds.dim(1).name == 'j');
+	REQUIRE(ds.dim(1).stride == sizeof(float));
+	REQUIRE(ds.find('j') == 1);
+	REQUIRE(ds.find('k') == 2);
+	REQUIRE(ds.is_dense());
+	REQUIRE(ds.size() == (s | noarr::get_size()));
+
+	noarr::traverser(s).for_each([&](auto state) {
+		std::size_t indices[] = {noarr::get_index<'i'>(state), noarr::get_index<'j'>(state)};
+		REQUIRE(ds.offset_of(indices) == (s | noarr::offset(state)));
+	});
+}
+
+TEST_CASE("Dynamic struct from a sliced structure", "[dynamic_struct]") {
+	auto s = noarr::scalar<int>() ^ noarr::sized_vector<'j'>(30) ^ noarr::sized_vector<'i'>(20) ^ noarr::slice<'j'>(5, 10) ^ noarr::fix<'i'>(3);
+	auto maybe_ds = noarr::to_dynamic_struct(s);
+	REQUIRE(maybe_ds);
+	const noarr::dynamic_struct &ds = *maybe_ds;
+
+	REQUIRE(ds.rank() == 1);
+	REQUIRE(ds.dim(0).name == 'j');
+	REQUIRE(ds.dim(0).length == 10);
+	REQUIRE(ds.offset() == (3 * 30 + 5) * sizeof(int));
+	REQUIRE(!noarr::with_static<int, noarr::char_sequence<'j'>>(ds, [](auto) {}));
+
+	std::size_t idx = 7;
+	REQUIRE(ds.offset_of(&idx) == (s | noarr::offset<'j'>(7)));
+}
+
+TEST_CASE("Dynamic struct from a non-affine structure", "[dynamic_struct]") {
+	auto s = noarr::scalar<int>() ^ noarr::sized_vectors<'x', 'y'>(4, 4);
+	REQUIRE(noarr::to_dynamic_struct(s));
+	REQUIRE(!noarr::to_dynamic_struct(s ^ noarr::merge_zcurve<'y', 'x', 'z'>::maxlen_alignment<4, 2>()));
+}
+
+TEST_CASE("Dynamic struct dispatch", "[dynamic_struct]") {
+	auto ds = noarr::dynamic_struct::dense(sizeof(double), "ji", {4, 3});
+	REQUIRE(ds.is_dense());
+	REQUIRE(ds.dim(1).stride == sizeof(double));
+	REQUIRE(ds.size() == 12 * sizeof(double));
+
+	std::vector<double> data(12);
+	for(std::size_t k = 0; k < data.size(); k++)
+		data[k] = double(k);
+
+	int matched = 0;
+	bool found = noarr::with_static<double, noarr::char_sequence<'i', 'j'>, noarr::char_sequence<'j', 'i'>>(ds, [&](auto s) {
+		using sig = typename decltype(s)::signature;
+		REQUIRE(sig::dim == 'j');
+		matched++;
+
+		auto bag = noarr::make_bag(s, data.data());
+		REQUIRE((bag.template get_length<'i'>()) == 3);
+		REQUIRE((bag.template get_length<'j'>()) == 4);
+		REQUIRE((bag.template at<'i', 'j'>(2, 1)) == 5);
+	});
+
+	REQUIRE(found);
+	REQUIRE(matched == 1);
+
+	REQUIRE(!noarr::with_static<float, noarr::char_sequence<'j', 'i'>>(ds, [](auto) {}));
+	REQUIRE(!noarr::with_static<double, noarr::char_sequence<'i', 'j'>>(ds, [](auto) {}));
+	REQUIRE(!noarr::with_static<double, noarr::char_sequence<'j'>>(ds, [](auto) {}));
+
+	noarr::dynamic_struct strided(sizeof(double), {{'j', 4, 6 * sizeof(double)}, {'i', 3, sizeof(double)}});
+	REQUIRE(!strided.is_dense());
+	REQUIRE(!noarr::with_static<double, noarr::char_sequence<'j', 'i'>>(strided, [](auto) {}));
+}
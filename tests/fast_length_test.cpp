@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+
+static_assert(std::size_t(100) / noarr::fast_length(7) == 14);
+static_assert(std::size_t(100) % noarr::fast_length(7) == 2);
+static_assert(std::size_t(100) / noarr::fast_length(16) == 6);
+static_assert(std::size_t(100) % noarr::fast_length(16) == 4);
+
+TEST_CASE("Fast length division", "[fast_length]") {
+	constexpr std::size_t max = std::numeric_limits<std::size_t>::max();
+	const std::size_t divisors[] = {1, 2, 3, 5, 6, 7, 10, 12, 64, 100, 641, 1000, 1024, 4093, 65535, 65536, 1'000'000'007, max / 3, max / 2, max / 2 + 1, max - 1, max};
+
+	for(std::size_t d : divisors) {
+		const noarr::fast_length fd(d);
+		REQUIRE(std::size_t(fd) == d);
+
+		const std::size_t numerators[] = {0, 1, d - 1, d, d + 1, 2 * d - 1, 12345, 999'999'999'999, max / 2, max - d, max - 1, max};
+		for(std::size_t n : numerators) {
+			REQUIRE(n / fd == n / d);
+			REQUIRE(n % fd == n % d);
+		}
+		for(std::size_t n = 0; n < 10'000; n++) {
+			REQUIRE(n / fd == n / d);
+			REQUIRE(n % fd == n % d);
+		}
+	}
+}
+
+TEST_CASE("Fast length in blocked structures", "[fast_length blocks]") {
+	auto plain = noarr::scalar<int>() ^ noarr::vector<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(37, 13) ^ noarr::merge_blocks<'i', 'j', 'x'>();
+	auto fast = noarr::scalar<int>() ^ noarr::vector<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(37, noarr::fast_length(13)) ^ noarr::merge_blocks<'i', 'j', 'x'>();
+
+	REQUIRE(std::is_same_v<decltype(fast | noarr::get_length<'j'>()), noarr::fast_length>);
+	REQUIRE(decltype(fast)::signature::template all_accept<'x'>);
+	REQUIRE((fast | noarr::get_length<'x'>()) == 37 * 13);
+	REQUIRE((fast | noarr::get_size()) == (plain | noarr::get_size()));
+
+	noarr::traverser(plain).for_each([&](auto state) {
+		REQUIRE((fast | noarr::offset(state)) == (plain | noarr::offset(state)));
+	});
+
+	auto blocks = noarr::scalar<int>() ^ noarr::sized_vector<'i'>(1000) ^ noarr::into_blocks<'i', 'I', 'i'>(noarr::fast_length(24));
+	REQUIRE((blocks | noarr::get_length<'I'>()) == 1000 / 24);
+	REQUIRE((blocks | noarr::offset<'I', 'i'>(5, 7)) == (5 * 24 + 7) * sizeof(int));
+
+	auto strided = noarr::scalar<int>() ^ noarr::sized_vector<'i'>(1000) ^ noarr::step<'i'>(3, noarr::fast_length(7));
+	REQUIRE((strided | noarr::get_length<'i'>()) == (1000 - 3 + 6) / 7);
+	REQUIRE((strided | noarr::offset<'i'>(5)) == (5 * 7 + 3) * sizeof(int));
+}
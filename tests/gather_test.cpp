@@ -0,0 +1,87 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/gather.hpp>
+#include <noarr/structures/interop/bag.hpp>
+
+TEST_CASE("Gather elements", "[gather]") {
+	auto in = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'i'>(100));
+	auto idx = noarr::make_bag(noarr::scalar<unsigned>() ^ noarr::sized_vector<'i'>(300));
+	auto out = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'i'>(300));
+
+	noarr::traverser(in).for_each([&](auto state) { in[state] = int(noarr::get_index<'i'>(state)) * 3 - 7; });
+	noarr::traverser(idx).for_each([&](auto state) { idx[state] = unsigned(noarr::get_index<'i'>(state) * 31 % 100); });
+
+	noarr::gather<'i'>(in, idx, out);
+
+	for(std::size_t i = 0; i < 300; i++)
+		REQUIRE(out.at<'i'>(i) == int(i * 31 % 100) * 3 - 7);
+}
+
+TEST_CASE("Gather rows", "[gather]") {
+	auto in = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vectors<'j', 'i'>(5, 40));
+	auto idx = noarr::make_bag(noarr::scalar<std::size_t>() ^ noarr::sized_vector<'k'>(10));
+	auto out = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vectors<'k', 'j'>(10, 5));
+
+	noarr::traverser(in).for_each([&](auto state) {
+		auto [i, j] = noarr::get_indices<'i', 'j'>(state);
+		in[state] = float(i * 10 + j);
+	});
+	noarr::traverser(idx).for_each([&](auto state) { idx[state] = 39 - 4 * noarr::get_index<'k'>(state); });
+
+	noarr::gather<'i'>(in, idx, out);
+
+	for(std::size_t k = 0; k < 10; k++)
+		for(std::size_t j = 0; j < 5; j++)
+			REQUIRE(out.at<'k', 'j'>(k, j) == float((39 - 4 * k) * 10 + j));
+}
+
+TEST_CASE("Scatter elements", "[gather]") {
+	auto in = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'k'>(64));
+	auto idx = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'k'>(64));
+	auto out = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'i'>(64));
+
+	noarr::traverser(in).for_each([&](auto state) {
+		std::size_t k = noarr::get_index<'k'>(state);
+		in[state] = int(k);
+		idx[state] = int(k * 5 % 64);
+	});
+
+	noarr::scatter<'i'>(in, idx, out);
+
+	for(std::size_t k = 0; k < 64; k++)
+		REQUIRE(out.at<'i'>(k * 5 % 64) == int(k));
+}
+
+TEST_CASE("Scatter with conflicts", "[gather]") {
+	auto in = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'k'>(1000));
+	auto idx = noarr::make_bag(noarr::scalar<std::size_t>() ^ noarr::sized_vector<'k'>(1000));
+	auto sums = noarr::make_bag(noarr::scalar<long>() ^ noarr::sized_vector<'b'>(7));
+	auto maxes = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'b'>(7));
+
+	noarr::traverser(in).for_each([&](auto state) {
+		std::size_t k = noarr::get_index<'k'>(state);
+		in[state] = int(k % 13);
+		idx[state] = k % 7;
+	});
+	noarr::traverser(sums).for_each([&](auto state) {
+		sums[state] = 100;
+		maxes[state] = 0;
+	});
+
+	noarr::scatter<'b'>(in, idx, sums, noarr::reduce_sum());
+	noarr::scatter<'b'>(in, idx, maxes, noarr::reduce_max());
+
+	for(std::size_t b = 0; b < 7; b++) {
+		long sum = 100;
+		int max = 0;
+		for(std::size_t k = b; k < 1000; k += 7) {
+			sum += long(k % 13);
+			max = int(k % 13) > max ? int(k % 13) : max;
+		}
+		REQUIRE(sums.at<'b'>(b) == sum);
+		REQUIRE(maxes.at<'b'>(b) == max);
+	}
+}
@@ -0,0 +1,67 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/mangle.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/interop/kernel_registry.hpp>
+
+namespace {
+
+auto rows(std::size_t nrows, std::size_t ncols) {
+	return noarr::scalar<float>() ^ noarr::sized_vector<'j'>(ncols) ^ noarr::sized_vector<'i'>(nrows);
+}
+
+auto cols(std::size_t nrows, std::size_t ncols) {
+	return noarr::scalar<float>() ^ noarr::sized_vector<'i'>(nrows) ^ noarr::sized_vector<'j'>(ncols);
+}
+
+} // namespace
+
+TEST_CASE("Kernel registry dispatch", "[kernel_registry]") {
+	noarr::kernel_registry<float *, float &> registry;
+
+	int specialized = 0;
+	registry.add<decltype(rows(0, 0)), decltype(cols(0, 0))>([&](auto s, float *data, float &sum) {
+		auto bag = noarr::make_bag(s, data);
+		noarr::traverser(bag).for_each([&](auto state) {
+			sum += bag[state] * float(noarr::get_index<'i'>(state));
+		});
+		specialized++;
+	});
+	REQUIRE(registry.size() == 2);
+
+	std::string fallback_description;
+	registry.set_fallback([&](std::string_view description, float *, float &) {
+		fallback_description = description;
+	});
+
+	std::vector<float> data(6, 1.0f);
+
+	float sum = 0;
+	std::string description = noarr::mangle_expr<std::string>(rows(2, 3));
+	REQUIRE(registry.contains(description));
+	REQUIRE(registry(description, data.data(), sum));
+	REQUIRE(sum == 3);
+
+	sum = 0;
+	REQUIRE(registry(noarr::mangle_expr<std::string>(cols(3, 2)), data.data(), sum));
+	REQUIRE(sum == 6);
+	REQUIRE(specialized == 2);
+
+	std::string other = noarr::mangle_expr<std::string>(noarr::scalar<float>() ^ noarr::array<'i', 6>());
+	REQUIRE(!registry.contains(other));
+	REQUIRE(!registry(other, data.data(), sum));
+	REQUIRE(fallback_description == other);
+	REQUIRE(specialized == 2);
+
+	// a known type, but a malformed description
+	std::string broken = description.substr(0, description.size() - 2);
+	REQUIRE(registry.contains(broken));
+	REQUIRE(!registry(broken, data.data(), sum));
+	REQUIRE(fallback_description == broken);
+}
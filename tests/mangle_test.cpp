@@ -3,7 +3,10 @@
 #include <noarr/structures_extended.hpp>
 #include <noarr/structures/extra/mangle.hpp>
 
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <stdint.h>
 
 template<char... Chars>
@@ -39,3 +42,44 @@ TEST_CASE("Mangle expr", "[mangle]") {
 
 	REQUIRE(expected == actual);
 }
+
+TEST_CASE("Unmangle expr", "[mangle]") {
+	auto structure = noarr::scalar<float>() ^ noarr::sized_vector<'x'>(42) ^ noarr::vector<'y'>() ^ noarr::set_length<'y'>(noarr::lit<24>) ^ noarr::into_blocks<'x', 'u', 'v'>(std::size_t(6)) ^ noarr::fix<'u'>(3);
+	using s = decltype(structure);
+	std::string description = noarr::mangle_expr<std::string>(structure);
+
+	auto parsed = noarr::unmangle_expr<s>(description);
+	REQUIRE(parsed.has_value());
+	REQUIRE(noarr::mangle_expr<std::string>(*parsed) == description);
+	REQUIRE((*parsed | noarr::get_length<'v'>()) == 6);
+	REQUIRE((*parsed | noarr::offset<'v', 'y'>(2, 5)) == (structure | noarr::offset<'v', 'y'>(2, 5)));
+
+	REQUIRE(!noarr::unmangle_expr<s>(description + " "));
+	REQUIRE(!noarr::unmangle_expr<s>(description.substr(0, description.size() - 1)));
+	REQUIRE(!noarr::unmangle_expr<decltype(noarr::scalar<int>() ^ noarr::sized_vector<'x'>(42))>(description));
+}
+
+TEST_CASE("Unmangle expr out-of-range literals", "[mangle]") {
+	auto structure = noarr::scalar<float>() ^ noarr::sized_vector<'x'>(42);
+	using s = decltype(structure);
+	std::string description = noarr::mangle_expr<std::string>(structure);
+	const std::size_t pos = description.find("{42}");
+	REQUIRE(pos != std::string::npos);
+	auto with_length = [&](const std::string &length) { return std::string(description).replace(pos + 1, 2, length); };
+
+	REQUIRE((*noarr::unmangle_expr<s>(with_length("18446744073709551615")) | noarr::get_length<'x'>()) == std::size_t(-1));
+	// 2^64 + 5 would wrap around to 5
+	REQUIRE(!noarr::unmangle_expr<s>(with_length("18446744073709551621")));
+	REQUIRE(!noarr::unmangle_expr<s>(with_length("100000000000000000000")));
+
+	using parser = noarr::helpers::unmangle_expr_helpers;
+	auto parse = [](auto value, std::string_view text) { return parser::parse_int(text, value) && text.empty() ? std::optional(value) : std::nullopt; };
+	REQUIRE(parse(std::int32_t(), "2147483647") == 2147483647);
+	REQUIRE(parse(std::int32_t(), "-2147483648") == -2147483647 - 1);
+	REQUIRE(!parse(std::int32_t(), "2147483648"));
+	REQUIRE(!parse(std::int32_t(), "-2147483649"));
+	REQUIRE(!parse(std::uint32_t(), "4294967297"));
+	REQUIRE(parse(std::uint8_t(), "255") == 255);
+	REQUIRE(!parse(std::uint8_t(), "256"));
+	REQUIRE(!parse(std::int8_t(), "-129"));
+}
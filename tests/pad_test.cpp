@@ -0,0 +1,55 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/shortcuts.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/structs/pad.hpp>
+
+TEST_CASE("Pad offsets and lengths", "[pad]") {
+	auto grid = noarr::scalar<float>() ^ noarr::vector<'y'>() ^ noarr::vector<'x'>() ^ noarr::pad<'x', 'y'>(1, 2) ^ noarr::set_length<'x', 'y'>(10, 20);
+	auto dense = noarr::scalar<float>() ^ noarr::sized_vectors<'y', 'x'>(23, 13);
+
+	REQUIRE((grid | noarr::get_length<'x'>()) == 10);
+	REQUIRE((grid | noarr::get_length<'y'>()) == 20);
+	REQUIRE((grid | noarr::get_size()) == 13 * 23 * sizeof(float));
+	REQUIRE((grid | noarr::offset<'x', 'y'>(0, 0)) == (dense | noarr::offset<'x', 'y'>(1, 1)));
+	REQUIRE((grid | noarr::offset<'x', 'y'>(9, 19)) == (dense | noarr::offset<'x', 'y'>(10, 20)));
+
+	auto state = noarr::idx<'x', 'y'>(std::size_t(0), std::size_t(19));
+	REQUIRE((grid | noarr::offset(noarr::neighbor<'x', 'y'>(state, -1, 2))) == (dense | noarr::offset<'x', 'y'>(0, 22)));
+
+	// padding an already sized structure exposes its interior
+	auto interior = dense ^ noarr::pad<'x'>(noarr::lit<1>, noarr::lit<2>);
+	REQUIRE((interior | noarr::get_length<'x'>()) == 10);
+	REQUIRE((interior | noarr::offset<'x', 'y'>(0, 3)) == (dense | noarr::offset<'x', 'y'>(1, 3)));
+	auto fixed = noarr::scalar<float>() ^ noarr::array<'x', 12>() ^ noarr::pad<'x'>(noarr::lit<1>, noarr::lit<1>);
+	static_assert(decltype(fixed | noarr::get_length<'x'>())::value == 10);
+}
+
+TEST_CASE("Pad stride", "[pad]") {
+	auto matrix = noarr::scalar<float>() ^ noarr::vector<'j'>() ^ noarr::pad_stride<'j'>(16) ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(8, 1024);
+	REQUIRE((matrix | noarr::get_length<'j'>()) == 1024);
+	REQUIRE((matrix | noarr::get_size()) == 8 * 1040 * sizeof(float));
+	REQUIRE((matrix | noarr::offset<'i', 'j'>(3, 5)) == (3 * 1040 + 5) * sizeof(float));
+
+	// the automatic padding rounds a row up to an odd number of cache lines
+	auto automatic = noarr::scalar<float>() ^ noarr::vector<'j'>() ^ noarr::pad_stride<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(8, 1024);
+	REQUIRE((automatic | noarr::get_length<'j'>()) == 1024);
+	REQUIRE((automatic | noarr::get_size()) == 8 * 1040 * sizeof(float));
+	auto odd = noarr::scalar<double>() ^ noarr::vector<'j'>() ^ noarr::pad_stride<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(8, 100);
+	REQUIRE((odd | noarr::get_size()) == 8 * 104 * sizeof(double)); // 800 B -> 13 lines
+	auto small = noarr::scalar<float>() ^ noarr::vector<'j'>() ^ noarr::pad_stride<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(8, 4);
+	REQUIRE((small | noarr::get_size()) == 8 * 4 * sizeof(float));
+
+	auto bag = noarr::make_bag(automatic);
+	REQUIRE(bag.get_size() == 8 * 1040 * sizeof(float));
+	std::size_t count = 0;
+	noarr::traverser(bag).for_each([&](auto state) {
+		bag[state] = float(noarr::get_index<'i'>(state) * 1024 + noarr::get_index<'j'>(state));
+		count++;
+	});
+	REQUIRE(count == 8 * 1024);
+	REQUIRE(bag.at<'i', 'j'>(7, 1023) == 7 * 1024 + 1023);
+	REQUIRE(bag.at<'i', 'j'>(5, 0) == 5 * 1024);
+}
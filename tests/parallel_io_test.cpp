@@ -0,0 +1,62 @@
+#include <catch2/catch_test_macros.hpp>
+
+// the parallel I/O uses the POSIX pread and pwrite
+#ifndef _WIN32
+
+#include <cstdio>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/interop/parallel_io.hpp>
+
+TEST_CASE("Parallel binary write and read", "[parallel_io]") {
+	std::FILE *file = std::tmpfile();
+	REQUIRE(file != nullptr);
+	const int fd = fileno(file);
+
+	auto s = noarr::scalar<int>() ^ noarr::sized_vector<'j'>(50) ^ noarr::sized_vector<'i'>(40);
+	auto bag = noarr::make_bag(s);
+	noarr::traverser(bag).for_each([&](auto state) {
+		bag[state] = int(noarr::get_index<'i'>(state) * 100 + noarr::get_index<'j'>(state));
+	});
+
+	// contiguous parts, after a 16-byte header
+	REQUIRE(noarr::pwrite_data(fd, 16, bag, 3));
+	std::vector<int> contents(40 * 50);
+	REQUIRE(noarr::pread_data(fd, 16, noarr::scalar<int>() ^ noarr::sized_vector<'k'>(40 * 50), contents.data(), 1));
+	REQUIRE(contents[0] == 0);
+	REQUIRE(contents[51] == 101);
+	REQUIRE(contents[40 * 50 - 1] == 3949);
+
+	// the transposed traversal is not contiguous
+	auto transposed = s ^ noarr::hoist<'j'>();
+	REQUIRE(noarr::pwrite_data(fd, 0, transposed, bag.data(), 4));
+	REQUIRE(noarr::pread_data(fd, 0, noarr::scalar<int>() ^ noarr::sized_vector<'k'>(40 * 50), contents.data()));
+	REQUIRE(contents[1] == 100);
+	REQUIRE(contents[40] == 1);
+
+	auto copy = noarr::make_bag(s);
+	REQUIRE(noarr::pread_data(fd, 0, transposed, copy.data(), 7));
+	noarr::traverser(bag).for_each([&](auto state) {
+		REQUIRE(copy[state] == bag[state]);
+	});
+
+	// the file is too short
+	auto larger = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'j'>(50) ^ noarr::sized_vector<'i'>(41));
+	REQUIRE(!noarr::pread_data(fd, 0, larger, 2));
+	REQUIRE(!noarr::pread_data(fd, 0, larger.structure() ^ noarr::hoist<'j'>(), larger.data(), 2));
+
+	// a literal zero is the thread count, not a null data pointer
+	REQUIRE(noarr::pwrite_data(fd, 0, bag, 0));
+	REQUIRE(noarr::pread_data(fd, 0, copy, 0));
+	REQUIRE(noarr::pread_data(fd, 0, noarr::make_bag(s, copy.data()), 0));
+	noarr::traverser(bag).for_each([&](auto state) {
+		REQUIRE(copy[state] == bag[state]);
+	});
+
+	std::fclose(file);
+}
+
+#endif // _WIN32
@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/reduce.hpp>
+#include <noarr/structures/interop/bag.hpp>
+
+TEST_CASE("Reduce along innermost dimension", "[reduce]") {
+	auto in = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'z', 'y', 'x'>(5, 4, 3));
+	auto out = noarr::make_bag(noarr::scalar<long>() ^ noarr::sized_vectors<'y', 'x'>(4, 3));
+
+	noarr::traverser(in).for_each([&](auto state) {
+		auto [x, y, z] = noarr::get_indices<'x', 'y', 'z'>(state);
+		in[state] = int(100*x + 10*y + z);
+	});
+
+	noarr::reduce_along<'z'>(in, out, noarr::reduce_sum());
+
+	for(std::size_t x = 0; x < 3; x++)
+		for(std::size_t y = 0; y < 4; y++)
+			REQUIRE(out.at<'x', 'y'>(x, y) == long(5*(100*x + 10*y) + 0+1+2+3+4));
+}
+
+TEST_CASE("Reduce along outer dimension", "[reduce]") {
+	auto in = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'x', 'z'>(6, 7));
+	auto out_sum = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'x'>(6));
+	auto out_max = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'x'>(6));
+	auto out_min = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'x'>(6));
+
+	noarr::traverser(in).for_each([&](auto state) {
+		auto [x, z] = noarr::get_indices<'x', 'z'>(state);
+		in[state] = int((x + 3*z) % 10);
+	});
+
+	noarr::reduce_along<'z'>(in, out_sum, noarr::reduce_sum());
+	noarr::reduce_along<'z'>(in, out_max, noarr::reduce_max());
+	noarr::reduce_along<'z'>(in, out_min, noarr::reduce_min());
+
+	for(std::size_t x = 0; x < 6; x++) {
+		int sum = 0, max = 0, min = 10;
+		for(std::size_t z = 0; z < 7; z++) {
+			int v = int((x + 3*z) % 10);
+			sum += v;
+			max = v > max ? v : max;
+			min = v < min ? v : min;
+		}
+		REQUIRE(out_sum.at<'x'>(x) == sum);
+		REQUIRE(out_max.at<'x'>(x) == max);
+		REQUIRE(out_min.at<'x'>(x) == min);
+	}
+}
+
+TEST_CASE("Reduce argmax and argmin", "[reduce]") {
+	auto in = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vectors<'i', 'j'>(8, 3));
+	auto out_max = noarr::make_bag(noarr::scalar<std::uint32_t>() ^ noarr::sized_vector<'j'>(3));
+	auto out_min = noarr::make_bag(noarr::scalar<std::uint32_t>() ^ noarr::sized_vector<'j'>(3));
+
+	noarr::traverser(in).for_each([&](auto state) {
+		auto [i, j] = noarr::get_indices<'i', 'j'>(state);
+		in[state] = float((i + 2*j) % 8) - 4.0f;
+	});
+
+	noarr::reduce_along<'i'>(in, out_max, noarr::reduce_argmax());
+	noarr::reduce_along<'i'>(in, out_min, noarr::reduce_argmin());
+
+	for(std::size_t j = 0; j < 3; j++) {
+		REQUIRE(out_max.at<'j'>(j) == (7 + 8 - 2*j) % 8);
+		REQUIRE(out_min.at<'j'>(j) == (8 - 2*j) % 8);
+	}
+}
+
+TEST_CASE("Reduce Kahan summation", "[reduce]") {
+	constexpr std::size_t n = 100000;
+	auto in = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vector<'i'>(n) ^ noarr::sized_vector<'r'>(2));
+	auto out_kahan = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vector<'r'>(2));
+	auto out_naive = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vector<'r'>(2));
+
+	noarr::traverser(in).for_each([&](auto state) {
+		in[state] = noarr::get_index<'i'>(state) ? 0.1f : 1e7f;
+	});
+
+	noarr::reduce_along<'i'>(in, out_kahan, noarr::reduce_kahan_sum());
+	noarr::reduce_along<'i'>(in, out_naive, noarr::reduce_sum());
+
+	float expected = 1e7f + 0.1f * (n - 1);
+	float kahan_error = out_kahan.at<'r'>(1) - expected;
+	float naive_error = out_naive.at<'r'>(1) - expected;
+	REQUIRE(out_kahan.at<'r'>(0) == out_kahan.at<'r'>(1));
+	REQUIRE((kahan_error < 1.0f && kahan_error > -1.0f));
+	REQUIRE((naive_error > 100.0f || naive_error < -100.0f));
+}
@@ -4,6 +4,8 @@
 #include <memory>
 
 #include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
 #include <noarr/structures/interop/serialize_data.hpp>
 
 TEST_CASE("Deserialize data", "[serialize_data]") {
@@ -93,3 +95,89 @@ TEST_CASE("Serialize data reordered", "[serialize_data]") {
 	REQUIRE(ok);
 	REQUIRE(stream.str() == "111\n222\n333\n444\n555\n666\n777\n888\n999\n");
 }
+
+TEST_CASE("Serialize data fast", "[serialize_data]") {
+	noarr::array<'x', 3, noarr::array<'y', 3, noarr::scalar<int>>> structure;
+	auto uptr = std::make_unique<char[]>(structure | noarr::get_size());
+	void *ptr = uptr.get();
+	std::stringstream input("111 222 333 444 555\n666 777 888 -999");
+	REQUIRE(!!deserialize_data(input, structure, ptr));
+
+	for(std::size_t num_threads : {1, 2, 3, 8}) {
+		std::stringstream stream;
+		bool ok = !!noarr::serialize_data_fast(stream, structure ^ noarr::reorder<'y', 'x'>(), ptr, num_threads);
+		REQUIRE(ok);
+		REQUIRE(stream.str() == "111\n444\n777\n222\n555\n888\n333\n666\n-999\n");
+	}
+}
+
+TEST_CASE("Deserialize data fast", "[serialize_data]") {
+	noarr::array<'x', 3, noarr::array<'y', 3, noarr::scalar<int>>> structure;
+	auto uptr = std::make_unique<char[]>(structure | noarr::get_size());
+	void *ptr = uptr.get();
+
+	std::stringstream stream("  111 222\t333 +444 555\n666 777 888 -999\n1000");
+	REQUIRE(!!noarr::deserialize_data_fast(stream, structure ^ noarr::reorder<'y', 'x'>(), ptr));
+	REQUIRE((structure | noarr::get_at<'x', 'y'>(ptr, 1, 0)) == 222);
+	REQUIRE((structure | noarr::get_at<'x', 'y'>(ptr, 0, 1)) == 444);
+	REQUIRE((structure | noarr::get_at<'x', 'y'>(ptr, 2, 2)) == -999);
+	int rest;
+	REQUIRE(stream >> rest);
+	REQUIRE(rest == 1000);
+
+	std::stringstream incomplete("1 2 3 4 5");
+	REQUIRE(!noarr::deserialize_data_fast(incomplete, structure, ptr));
+	REQUIRE(incomplete.eof());
+	std::stringstream malformed("1 2 3 4x 5 6 7 8 9");
+	REQUIRE(!noarr::deserialize_data_fast(malformed, structure, ptr));
+	REQUIRE(!malformed.eof());
+	std::stringstream signs("1 2 3 4 +-5 6 7 8 9");
+	REQUIRE(!noarr::deserialize_data_fast(signs, structure, ptr));
+
+	// the leading zeros do not count to the length limit, like in `operator>>`
+	std::stringstream zeros("00000000000042 -0000000000000000007 +000 0 -0 0000000000000000000000000000000 1 2 000000000000001234567890");
+	REQUIRE(!!noarr::deserialize_data_fast(zeros, structure, ptr));
+	REQUIRE((structure | noarr::get_at<'x', 'y'>(ptr, 0, 0)) == 42);
+	REQUIRE((structure | noarr::get_at<'x', 'y'>(ptr, 0, 1)) == -7);
+	REQUIRE((structure | noarr::get_at<'x', 'y'>(ptr, 0, 2)) == 0);
+	REQUIRE((structure | noarr::get_at<'x', 'y'>(ptr, 2, 2)) == 1234567890);
+	std::stringstream too_long("1 2 3 4 5 6 7 8 10000000000000000000000");
+	REQUIRE(!noarr::deserialize_data_fast(too_long, structure, ptr));
+
+	auto reals = noarr::make_bag(noarr::scalar<double>() ^ noarr::sized_vector<'i'>(5));
+	std::stringstream real_zeros("000.5 -00 0000000000000000000000000000000000000000000000000000000000000000000000001.25e1 0e0 1e999");
+	REQUIRE(!noarr::deserialize_data_fast(real_zeros, reals));
+	REQUIRE(reals.at<'i'>(0) == 0.5);
+	REQUIRE(reals.at<'i'>(1) == 0.0);
+	REQUIRE(reals.at<'i'>(2) == 12.5);
+	REQUIRE(reals.at<'i'>(3) == 0.0);
+}
+
+TEST_CASE("Serialize data fast floating-point round trip", "[serialize_data]") {
+	auto structure = noarr::scalar<double>() ^ noarr::sized_vector<'i'>(1000) ^ noarr::sized_vector<'j'>(7);
+	auto bag = noarr::make_bag(structure);
+	noarr::traverser(bag).for_each([&](auto state) {
+		bag[state] = 1.0 / double(noarr::get_index<'i'>(state) + 1) - double(noarr::get_index<'j'>(state)) * 1e100;
+	});
+
+	std::stringstream stream;
+	REQUIRE(!!noarr::serialize_data_fast(stream, bag));
+	auto copy = noarr::make_bag(structure);
+	REQUIRE(!!noarr::deserialize_data_fast(stream, copy));
+	noarr::traverser(bag).for_each([&](auto state) {
+		REQUIRE(copy[state] == bag[state]);
+	});
+
+	// an explicit thread count (a literal zero is not a null data pointer)
+	for(std::size_t num_threads : {0, 1, 3}) {
+		std::stringstream threaded;
+		REQUIRE(!!noarr::serialize_data_fast(threaded, bag, 0));
+		REQUIRE(!!noarr::serialize_data_fast(threaded, bag, num_threads));
+		auto twice = noarr::make_bag(structure);
+		REQUIRE(!!noarr::deserialize_data_fast(threaded, copy));
+		REQUIRE(!!noarr::deserialize_data_fast(threaded, twice));
+		noarr::traverser(bag).for_each([&](auto state) {
+			REQUIRE(twice[state] == bag[state]);
+		});
+	}
+}
@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/shuffle.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/interop/chunked.hpp>
+#include <noarr/structures/interop/codec.hpp>
+#include <noarr/structures/structs/bytes.hpp>
+
+TEST_CASE("As bytes and byte planes", "[shuffle]") {
+	auto s = noarr::scalar<std::uint32_t>() ^ noarr::sized_vector<'j'>(5) ^ noarr::sized_vector<'i'>(3);
+	auto bytes = s ^ noarr::as_bytes<'b'>();
+	auto planes = s ^ noarr::byte_planes<'b'>();
+
+	REQUIRE((bytes | noarr::get_size()) == 60);
+	REQUIRE((planes | noarr::get_size()) == 60);
+	REQUIRE((bytes | noarr::get_length<'b'>()) == 4);
+	REQUIRE((planes | noarr::get_length<'b'>()) == 4);
+	REQUIRE(std::is_same_v<noarr::scalar_t<decltype(bytes)>, unsigned char>);
+	REQUIRE(std::is_same_v<noarr::scalar_t<decltype(planes)>, unsigned char>);
+
+	REQUIRE((bytes | noarr::offset<'i', 'j', 'b'>(2, 1, 3)) == (2 * 5 + 1) * 4 + 3);
+	REQUIRE((planes | noarr::offset<'i', 'j', 'b'>(2, 1, 3)) == 3 * 15 + 2 * 5 + 1);
+
+	// the byte dimension is innermost in the bytes and outermost in the planes
+	REQUIRE(decltype(bytes)::signature::ret_sig::ret_sig::dim == 'b');
+	REQUIRE(decltype(planes)::signature::dim == 'b');
+}
+
+TEST_CASE("Byte shuffle and delta encoding", "[shuffle]") {
+	auto s = noarr::scalar<float>() ^ noarr::sized_vector<'i'>(100) ^ noarr::sized_vector<'j'>(7) ^ noarr::slice<'i'>(10, 20);
+
+	auto data = noarr::make_bag(s);
+	noarr::traverser(data).for_each([&](auto state) {
+		data[state] = float(noarr::get_index<'i'>(state)) * 0.25f + float(noarr::get_index<'j'>(state));
+	});
+
+	std::vector<char> shuffled(s | noarr::get_size());
+	noarr::byte_shuffle(s, data.data(), shuffled.data());
+
+	auto planes = noarr::make_bag(s ^ noarr::byte_planes<'b'>(), shuffled.data());
+	noarr::traverser(data).for_each([&](auto state) {
+		unsigned char bytes[sizeof(float)];
+		std::memcpy(bytes, &data[state], sizeof(float));
+		for(std::size_t b = 0; b < sizeof(float); b++)
+			REQUIRE(planes[state.template with<noarr::index_in<'b'>>(b)] == bytes[b]);
+	});
+
+	// the differences along 'i' in each plane
+	noarr::delta_encode<'i'>(planes.structure(), shuffled.data());
+	REQUIRE(planes.template at<'b', 'j', 'i'>(3, 2, 5) == 0); // the most significant bytes do not change
+	noarr::delta_decode<'i'>(planes.structure(), shuffled.data());
+
+	auto copy = noarr::make_bag(s);
+	noarr::byte_unshuffle(s, shuffled.data(), copy.data());
+	noarr::traverser(data).for_each([&](auto state) {
+		REQUIRE(copy[state] == data[state]);
+	});
+
+	// the differences wrap around
+	std::vector<std::uint16_t> values{1, 3, 6, 10, 65535, 2};
+	auto v = noarr::scalar<std::uint16_t>() ^ noarr::sized_vector<'j'>(3) ^ noarr::sized_vector<'i'>(2);
+	noarr::delta_encode<'j'>(v, values.data());
+	REQUIRE(values == std::vector<std::uint16_t>{1, 2, 3, 10, 65525, 3});
+	noarr::delta_decode<'j'>(v, values.data());
+	REQUIRE(values == std::vector<std::uint16_t>{1, 3, 6, 10, 65535, 2});
+}
+
+TEST_CASE("Shuffle codec", "[shuffle]") {
+	using codec = noarr::shuffle_codec<sizeof(double), noarr::lz4_codec, true>;
+	REQUIRE(std::strcmp(codec::name, "b8dlz4") == 0);
+	REQUIRE(std::strcmp(noarr::shuffle_codec<12, noarr::raw_codec>::name, "b12raw") == 0);
+
+	std::vector<double> input(1000);
+	for(std::size_t i = 0; i < input.size(); i++)
+		input[i] = 1000.0 + double(i) * 0.5;
+
+	std::vector<char> encoded(codec().max_encoded_size(input.size() * sizeof(double) - 3));
+	encoded.resize(codec().encode(reinterpret_cast<const char *>(input.data()), input.size() * sizeof(double) - 3, encoded.data()));
+
+	std::vector<char> plain(noarr::lz4_codec().max_encoded_size(input.size() * sizeof(double)));
+	plain.resize(noarr::lz4_codec().encode(reinterpret_cast<const char *>(input.data()), input.size() * sizeof(double), plain.data()));
+	REQUIRE(encoded.size() < plain.size() / 4);
+
+	std::vector<double> decoded(input.size());
+	REQUIRE(codec().decode(encoded.data(), encoded.size(), reinterpret_cast<char *>(decoded.data()), input.size() * sizeof(double) - 3));
+	REQUIRE(std::memcmp(decoded.data(), input.data(), input.size() * sizeof(double) - 3) == 0);
+
+	// as the codec of a chunked array
+	auto s = noarr::scalar<double>() ^ noarr::sized_vector<'i'>(1000) ^ noarr::into_blocks<'i', 'I', 'i'>(250);
+	auto layout = noarr::chunk_layout<'I'>(s);
+	std::stringstream file;
+	REQUIRE(noarr::write_chunked(file, layout, input.data(), codec()));
+	noarr::chunked_reader<decltype(layout), codec> reader(layout, file);
+	REQUIRE(reader.good());
+	std::vector<double> copy(input.size());
+	REQUIRE(reader.decode_all(copy.data()));
+	REQUIRE(copy == input);
+}
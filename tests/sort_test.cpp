@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/interop/sort.hpp>
+
+TEST_CASE("Sort contiguous rows by an integral key", "[sort]") {
+	auto bag = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'j', 'i'>(3, 100));
+
+	noarr::traverser(bag).for_each([&](auto state) {
+		auto [i, j] = noarr::get_indices<'i', 'j'>(state);
+		bag[state] = j == 0 ? int((i * 37) % 10) - 5 : int(i);
+	});
+
+	auto perm = noarr::sort_along<'i'>(bag, [&](auto state) { return bag[state.template with<noarr::index_in<'j'>>(std::size_t(0))]; });
+
+	REQUIRE(perm.size() == 100);
+	for(std::size_t i = 0; i < 100; i++) {
+		REQUIRE(bag.at<'i', 'j'>(i, 1) == int(perm[i]));
+		REQUIRE(bag.at<'i', 'j'>(i, 2) == int(perm[i]));
+		REQUIRE(bag.at<'i', 'j'>(i, 0) == int((perm[i] * 37) % 10) - 5);
+		if(i > 0) {
+			REQUIRE(bag.at<'i', 'j'>(i - 1, 0) <= bag.at<'i', 'j'>(i, 0));
+			if(bag.at<'i', 'j'>(i - 1, 0) == bag.at<'i', 'j'>(i, 0))
+				REQUIRE(perm[i - 1] < perm[i]); // stable
+		}
+	}
+}
+
+TEST_CASE("Sort non-contiguous entries by a floating point key", "[sort]") {
+	// column-major: the entries along 'i' are the rows
+	auto bag = noarr::make_bag(noarr::scalar<double>() ^ noarr::sized_vectors<'i', 'j'>(50, 4));
+	auto keys = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vector<'i'>(50));
+
+	noarr::traverser(bag).for_each([&](auto state) {
+		auto [i, j] = noarr::get_indices<'i', 'j'>(state);
+		bag[state] = double(i * 10 + j);
+	});
+	noarr::traverser(keys).for_each([&](auto state) {
+		keys[state] = float(noarr::get_index<'i'>(state) % 7) * -0.5f;
+	});
+
+	auto perm = noarr::sort_along<'i'>(bag, [&](auto state) { return keys[state]; });
+
+	for(std::size_t i = 0; i < 50; i++) {
+		for(std::size_t j = 0; j < 4; j++)
+			REQUIRE(bag.at<'i', 'j'>(i, j) == double(perm[i] * 10 + j));
+		if(i > 0) {
+			REQUIRE(keys.at<'i'>(perm[i - 1]) <= keys.at<'i'>(perm[i]));
+			if(keys.at<'i'>(perm[i - 1]) == keys.at<'i'>(perm[i]))
+				REQUIRE(perm[i - 1] < perm[i]);
+		}
+	}
+}
+
+TEST_CASE("Permute a structure of arrays", "[sort]") {
+	constexpr std::size_t n = 20;
+	auto bag = noarr::make_bag(noarr::make_tuple<'t'>(noarr::scalar<int>() ^ noarr::array<'i', n>(), noarr::scalar<float>() ^ noarr::array<'i', n>()));
+
+	for(std::size_t i = 0; i < n; i++) {
+		bag.at<'t', 'i'>(noarr::lit<0>, i) = int(i);
+		bag.at<'t', 'i'>(noarr::lit<1>, i) = float(i) + 0.5f;
+	}
+
+	std::vector<std::size_t> perm(n);
+	for(std::size_t i = 0; i < n; i++)
+		perm[i] = (i * 7 + 3) % n;
+
+	noarr::permute<'i'>(bag, perm);
+
+	for(std::size_t i = 0; i < n; i++) {
+		REQUIRE(bag.at<'t', 'i'>(noarr::lit<0>, i) == int(perm[i]));
+		REQUIRE(bag.at<'t', 'i'>(noarr::lit<1>, i) == float(perm[i]) + 0.5f);
+	}
+}
+
+TEST_CASE("Sort wide signed keys", "[sort]") {
+	auto bag = noarr::make_bag(noarr::scalar<long long>() ^ noarr::sized_vector<'i'>(1000));
+
+	noarr::traverser(bag).for_each([&](auto state) {
+		long long i = (long long)noarr::get_index<'i'>(state);
+		bag[state] = (i * 7919 % 1000 - 500) * 1000000007LL;
+	});
+
+	noarr::sort_along<'i'>(bag, [&](auto state) { return bag[state]; });
+
+	for(std::size_t i = 1; i < 1000; i++)
+		REQUIRE(bag.at<'i'>(i - 1) < bag.at<'i'>(i));
+}
+
+TEST_CASE("Permute a shifted view", "[sort]") {
+	// 'i' is the outermost dimension, but the entries do not start at zero
+	auto bag = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'j', 'i'>(3, 12) ^ noarr::shift<'i'>(2));
+
+	noarr::traverser(bag).for_each([&](auto state) {
+		auto [i, j] = noarr::get_indices<'i', 'j'>(state);
+		bag[state] = int(i * 10 + j);
+	});
+
+	std::vector<std::size_t> perm(10);
+	for(std::size_t i = 0; i < 10; i++)
+		perm[i] = 9 - i;
+
+	noarr::permute<'i'>(bag, perm);
+
+	for(std::size_t i = 0; i < 10; i++)
+		for(std::size_t j = 0; j < 3; j++)
+			REQUIRE(bag.at<'i', 'j'>(i, j) == int((9 - i) * 10 + j));
+	// the elements outside the view are not touched
+	auto whole = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'j', 'i'>(3, 12), bag.data());
+	REQUIRE(whole.at<'i', 'j'>(0, 0) == 0);
+}
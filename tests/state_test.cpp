@@ -73,3 +73,33 @@ TEST_CASE("State shortcuts lit", "[state]") {
 	REQUIRE(decltype(s2x)::value == 05);
 	REQUIRE(decltype(s2y)::value == 15);
 }
+
+TEST_CASE("State slots", "[state]") {
+	constexpr auto s1 = noarr::make_state<noarr::index_in<'x'>, noarr::length_in<'x'>, noarr::index_in<'y'>, noarr::length_in<'y'>>(3, noarr::lit<10>, 4, noarr::lit<20>);
+
+	static_assert(sizeof(s1) == 2*sizeof(std::size_t));
+	static_assert(s1.get<noarr::index_in<'y'>>() == 4);
+	REQUIRE(noarr_test::type_is_simple(s1));
+
+	auto s2 = s1.with<noarr::index_in<'z'>, noarr::length_in<'z'>>(5, std::integral_constant<std::size_t, 30>());
+
+	REQUIRE(sizeof(s2) == 3*sizeof(std::size_t));
+	REQUIRE(noarr_test::type_is_simple(s2));
+	REQUIRE(std::is_same_v<noarr::state_get_t<decltype(s2), noarr::length_in<'z'>>, std::integral_constant<std::size_t, 30>>);
+
+	s2.get_ref<noarr::index_in<'x'>>() = 6;
+	s2.get_ref<noarr::index_in<'z'>>()++;
+
+	REQUIRE(s2.get<noarr::index_in<'x'>>() == 6);
+	REQUIRE(s2.get<noarr::index_in<'y'>>() == 4);
+	REQUIRE(s2.get<noarr::index_in<'z'>>() == 6);
+	REQUIRE(s1.get<noarr::index_in<'x'>>() == 3);
+
+	auto s3 = s2.remove<noarr::index_in<'x'>, noarr::length_in<'y'>>();
+
+	REQUIRE(sizeof(s3) == 2*sizeof(std::size_t));
+	REQUIRE(!decltype(s3)::contains<noarr::index_in<'x'>>);
+	REQUIRE(s3.get<noarr::index_in<'y'>>() == 4);
+	REQUIRE(s3.get<noarr::index_in<'z'>>() == 6);
+	REQUIRE(decltype(s3.get<noarr::length_in<'x'>>())::value == 10);
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/shortcuts.hpp>
+#include <noarr/structures/extra/stencil.hpp>
+#include <noarr/structures/interop/bag.hpp>
+
+TEST_CASE("Stencil interior and boundary", "[stencil]") {
+	auto counts = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'x', 'y'>(7, 5));
+	auto where = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'x', 'y'>(7, 5));
+	auto t = noarr::traverser(counts);
+	auto s = noarr::stencil<'x', 'y'>(2, 1);
+
+	t.for_each([&](auto state) { counts[state] = 0; });
+	s.interior(t).for_each([&](auto state) { counts[state] += 1; where[state] = 1; });
+	s.for_each_boundary(t, [&](auto state) { counts[state] += 1; where[state] = 2; });
+
+	t.for_each([&](auto state) {
+		auto [x, y] = noarr::get_indices<'x', 'y'>(state);
+		REQUIRE(counts[state] == 1);
+		REQUIRE(where[state] == (x >= 2 && x < 5 && y >= 1 && y < 4 ? 1 : 2));
+	});
+}
+
+TEST_CASE("Stencil wider than the structure", "[stencil]") {
+	auto counts = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'x', 'y'>(3, 4));
+	auto t = noarr::traverser(counts);
+	auto s = noarr::stencil<'x', 'y'>(2, 1);
+
+	t.for_each([&](auto state) { counts[state] = 0; });
+	s.interior(t).for_each([&](auto state) { counts[state] += 1; });
+	s.for_each_boundary(t, [&](auto state) { counts[state] += 1; });
+
+	t.for_each([&](auto state) { REQUIRE(counts[state] == 1); });
+}
+
+TEST_CASE("Stencil tiles", "[stencil]") {
+	auto counts = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'x', 'y', 'z'>(10, 9, 4));
+	auto t = noarr::traverser(counts);
+	auto s = noarr::stencil<'x', 'y'>(1, 1);
+	auto tiles = s.tiles(t, 3, 4);
+
+	REQUIRE(tiles.size() == 3 * 2);
+	REQUIRE(s.tiles(t, 0, 4).size() == 8 * 2); // a zero tile size is treated as one
+
+	t.for_each([&](auto state) { counts[state] = 0; });
+	for(std::size_t i = 0; i < tiles.size(); i++)
+		tiles[i].for_each([&](auto state) { counts[state] += 1; });
+	s.for_each_boundary(t, [&](auto state) { counts[state] += 1; });
+
+	t.for_each([&](auto state) { REQUIRE(counts[state] == 1); });
+}
+
+TEST_CASE("Stencil Jacobi step", "[stencil]") {
+	auto structure = noarr::scalar<int>() ^ noarr::sized_vectors<'x', 'y'>(12, 11);
+	auto in = noarr::make_bag(structure);
+	auto out = noarr::make_bag(structure);
+	auto t = noarr::traverser(in, out);
+	auto s = noarr::stencil<'x', 'y'>(1, 1);
+
+	t.for_each([&](auto state) {
+		auto [x, y] = noarr::get_indices<'x', 'y'>(state);
+		in[state] = int(x * x + 3 * y);
+	});
+
+	s.tiles(t, 4, 4).for_each([&](auto state) {
+		out[state] = in[noarr::neighbor<'x'>(state, -1)] + in[noarr::neighbor<'x'>(state, 1)]
+			+ in[noarr::neighbor<'y'>(state, -1)] + in[noarr::neighbor<'y'>(state, 1)];
+	});
+	s.for_each_boundary(t, [&](auto state) { out[state] = in[state]; });
+
+	for(std::size_t x = 0; x < 12; x++) {
+		for(std::size_t y = 0; y < 11; y++) {
+			int expected = in.at<'x', 'y'>(x, y);
+			if(x > 0 && x < 11 && y > 0 && y < 10)
+				expected = in.at<'x', 'y'>(x - 1, y) + in.at<'x', 'y'>(x + 1, y) + in.at<'x', 'y'>(x, y - 1) + in.at<'x', 'y'>(x, y + 1);
+			REQUIRE(out.at<'x', 'y'>(x, y) == expected);
+		}
+	}
+}
+
+TEST_CASE("Pad halo filling", "[stencil pad]") {
+	constexpr std::size_t nx = 5, ny = 4;
+	auto grid = noarr::make_bag(noarr::scalar<int>() ^ noarr::vector<'y'>() ^ noarr::vector<'x'>() ^ noarr::vector<'c'>() ^ noarr::pad<'x', 'y'>(2, 1) ^ noarr::set_length<'x', 'y', 'c'>(nx, ny, 2));
+	auto value = [](std::size_t x, std::size_t y, std::size_t c) { return int(x * 100 + y * 10 + c); };
+
+	noarr::traverser(grid).for_each([&](auto state) {
+		auto [x, y, c] = noarr::get_indices<'x', 'y', 'c'>(state);
+		grid[state] = value(x, y, c);
+	});
+
+	auto check = [&](auto expected) {
+		for(std::size_t c = 0; c < 2; c++)
+			for(std::ptrdiff_t x = -2; x < std::ptrdiff_t(nx) + 1; x++)
+				for(std::ptrdiff_t y = -2; y < std::ptrdiff_t(ny) + 1; y++)
+					REQUIRE(grid.at<'x', 'y', 'c'>(std::size_t(x), std::size_t(y), c) == expected(x, y, c));
+	};
+
+	noarr::fill_halo<'x', 'y'>(grid, noarr::pad_periodic());
+	check([&](std::ptrdiff_t x, std::ptrdiff_t y, std::size_t c) {
+		return value(std::size_t((x + nx) % nx), std::size_t((y + ny) % ny), c);
+	});
+
+	noarr::fill_halo<'x', 'y'>(grid, noarr::pad_clamp());
+	check([&](std::ptrdiff_t x, std::ptrdiff_t y, std::size_t c) {
+		return value(std::size_t(x < 0 ? 0 : x >= std::ptrdiff_t(nx) ? nx - 1 : x), std::size_t(y < 0 ? 0 : y >= std::ptrdiff_t(ny) ? ny - 1 : y), c);
+	});
+
+	noarr::fill_halo<'x', 'y'>(grid, noarr::pad_constant(-1));
+	check([&](std::ptrdiff_t x, std::ptrdiff_t y, std::size_t c) {
+		return x < 0 || y < 0 || x >= std::ptrdiff_t(nx) || y >= std::ptrdiff_t(ny) ? -1 : value(std::size_t(x), std::size_t(y), c);
+	});
+}
@@ -2,8 +2,12 @@
 
 #include <array>
 #include <iostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
 #include <noarr/structures_extended.hpp>
 
 using namespace noarr;
@@ -466,3 +470,81 @@ TEST_CASE("Traverser single state multi struct", "[traverser]") {
 	REQUIRE(get_index<'y'>(s) == 142);
 	REQUIRE(get_index<'z'>(s) == 242);
 }
+
+TEST_CASE("Traverser for_each states match for_sections", "[traverser shortcuts blocks]") {
+	auto t = traverser(scalar<int>() ^ array<'x', 20>() ^ array<'y', 30>()).order(strip_mine<'x', 'u', 'v'>(4));
+
+	std::vector<std::pair<std::size_t, std::size_t>> from_each, from_sections;
+
+	t.for_each([&](auto s) {
+		from_each.emplace_back(get_index<'x'>(s), get_index<'y'>(s));
+	});
+
+	t.for_sections([&](auto inner) {
+		auto s = inner.state();
+		from_sections.emplace_back(get_index<'x'>(s), get_index<'y'>(s));
+	});
+
+	REQUIRE(from_each.size() == 20*30);
+	REQUIRE(from_each == from_sections);
+}
+
+TEST_CASE("Traverser fills an uninitialized bag", "[traverser bag]") {
+	auto s = scalar<int>() ^ sized_vector<'x'>(20) ^ sized_vector<'y'>(30);
+	auto bag = make_uninitialized_bag(s);
+
+	REQUIRE(std::is_same_v<decltype(bag), decltype(make_bag(s))>);
+	REQUIRE((bag | get_size()) == 20*30*sizeof(int));
+
+	traverser(bag).for_each([&](auto state) {
+		bag[state] = int(get_index<'x'>(state) + 100 * get_index<'y'>(state));
+	});
+
+	REQUIRE(bag.template at<'x', 'y'>(7, 12) == 1207);
+	REQUIRE(bag.template at<'x', 'y'>(19, 29) == 2919);
+}
+
+TEST_CASE("Traverser tuple in a union", "[traverser]") {
+	auto aos = make_bag(make_tuple<'f'>(scalar<float>(), scalar<int>()) ^ sized_vector<'i'>(10));
+	auto soa = make_bag(make_tuple<'f'>(scalar<float>() ^ sized_vector<'i'>(10), scalar<int>() ^ sized_vector<'i'>(10)));
+	auto sums = make_bag(scalar<double>() ^ sized_vector<'i'>(10));
+
+	traverser(aos).for_each([&](auto state) {
+		aos[state] = std::remove_reference_t<decltype(aos[state])>(get_index<'i'>(state) * 10 + state.template get<index_in<'f'>>());
+	});
+
+	// the tuple dimension is added to the traversal by the second structure
+	std::size_t visited = 0;
+	traverser(sums, soa).for_each([&](auto state) {
+		static_assert(decltype(state)::template contains<index_in<'f'>>);
+		visited++;
+	});
+	REQUIRE(visited == 20);
+
+	// both structures have the tuple, each field is copied with its own type
+	traverser(aos, soa).for_each([&](auto state) {
+		soa[state] = aos[state];
+	});
+	REQUIRE(soa.template at<'f', 'i'>(lit<0>, 7) == 70.0f);
+	REQUIRE(soa.template at<'f', 'i'>(lit<1>, 7) == 71);
+
+	traverser(sums).for_each([&](auto state) {
+		sums[state] = 0;
+	});
+	traverser(sums, soa).for_each([&](auto state) {
+		sums[state] += soa[state];
+	});
+	REQUIRE(sums.template at<'i'>(3) == 30 + 31);
+}
+
+TEST_CASE("Traverser union takes the known length", "[traverser]") {
+	auto unknown = scalar<int>() ^ vector<'i'>() ^ sized_vector<'j'>(3);
+	auto known = scalar<int>() ^ sized_vector<'i'>(4);
+
+	using sig = typename decltype(traverser(unknown, known).top_struct())::signature;
+	REQUIRE(sig::template all_accept<'i'>);
+
+	std::size_t visited = 0;
+	traverser(unknown, known).for_each([&](auto) { visited++; });
+	REQUIRE(visited == 12);
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/structs/triangle.hpp>
+
+TEST_CASE("Triangle offsets and lengths", "[triangle]") {
+	auto lower = noarr::scalar<int>() ^ noarr::lower_triangle<'i', 'j'>(5);
+	auto strict = noarr::scalar<int>() ^ noarr::strict_lower_triangle<'i', 'j'>(5);
+	auto upper = noarr::scalar<int>() ^ noarr::upper_triangle<'i', 'j'>(5);
+
+	REQUIRE((lower | noarr::get_size()) == 15 * sizeof(int));
+	REQUIRE((strict | noarr::get_size()) == 10 * sizeof(int));
+	REQUIRE((upper | noarr::get_size()) == 15 * sizeof(int));
+
+	REQUIRE((lower | noarr::get_length<'i'>()) == 5);
+	REQUIRE((lower | noarr::get_length<'j'>(noarr::idx<'i'>(3))) == 4);
+	REQUIRE((strict | noarr::get_length<'j'>(noarr::idx<'i'>(3))) == 3);
+	REQUIRE((upper | noarr::get_length<'j'>()) == 5);
+	REQUIRE((upper | noarr::get_length<'i'>(noarr::idx<'j'>(3))) == 4);
+
+	REQUIRE((lower | noarr::offset<'i', 'j'>(3, 2)) == (6 + 2) * sizeof(int));
+	REQUIRE((strict | noarr::offset<'i', 'j'>(3, 2)) == (3 + 2) * sizeof(int));
+	REQUIRE((upper | noarr::offset<'i', 'j'>(2, 3)) == (6 + 2) * sizeof(int)); // LAPACK: i + j * (j + 1) / 2
+
+	// the traverser visits each stored element once, in the storage order
+	std::size_t expected = 0;
+	noarr::traverser(lower).for_each([&](auto state) {
+		REQUIRE(noarr::get_index<'j'>(state) <= noarr::get_index<'i'>(state));
+		REQUIRE((lower | noarr::offset(state)) == expected * sizeof(int));
+		expected++;
+	});
+	REQUIRE(expected == 15);
+	expected = 0;
+	noarr::traverser(upper).for_each([&](auto state) {
+		REQUIRE(noarr::get_index<'i'>(state) <= noarr::get_index<'j'>(state));
+		REQUIRE((upper | noarr::offset(state)) == expected * sizeof(int));
+		expected++;
+	});
+	REQUIRE(expected == 15);
+}
+
+TEST_CASE("Triangle of a dense matrix", "[triangle]") {
+	constexpr std::size_t n = 7;
+	auto dense = noarr::make_bag(noarr::scalar<float>() ^ noarr::vector<'j'>() ^ noarr::vector<'i'>() ^ noarr::set_length<'i', 'j'>(n, n));
+	auto packed = noarr::make_bag(noarr::scalar<float>() ^ noarr::lower_triangle<'i', 'j'>(n));
+
+	noarr::traverser(dense).for_each([&](auto state) {
+		dense[state] = float(noarr::get_index<'i'>(state) * 10 + noarr::get_index<'j'>(state));
+	});
+
+	// the triangle determines the traversed elements
+	std::size_t count = 0;
+	noarr::traverser(packed, dense).for_each([&](auto state) {
+		packed[state] = dense[state];
+		count++;
+	});
+	REQUIRE(count == n * (n + 1) / 2);
+
+	// also if the full matrix is listed first
+	auto copy = noarr::make_bag(noarr::scalar<float>() ^ noarr::lower_triangle<'i', 'j'>(n));
+	count = 0;
+	noarr::traverser(dense, copy).for_each([&](auto state) {
+		REQUIRE(noarr::get_index<'j'>(state) <= noarr::get_index<'i'>(state));
+		copy[state] = dense[state];
+		count++;
+	});
+	REQUIRE(count == n * (n + 1) / 2);
+	noarr::traverser(packed).for_each([&](auto state) {
+		REQUIRE(copy[state] == packed[state]);
+	});
+
+	// the same data viewed as a symmetric matrix
+	auto sym = noarr::make_bag(noarr::scalar<float>() ^ noarr::symmetric<'i', 'j'>(n), packed.data());
+	REQUIRE((sym | noarr::get_length<'j'>()) == n);
+	count = 0;
+	noarr::traverser(sym).for_each([&](auto state) {
+		std::size_t i = noarr::get_index<'i'>(state), j = noarr::get_index<'j'>(state);
+		REQUIRE(sym[state] == float(i >= j ? i * 10 + j : j * 10 + i));
+		count++;
+	});
+	REQUIRE(count == n * n);
+}
+
+TEST_CASE("Blocked triangle rank-k update", "[triangle]") {
+	constexpr std::size_t block = 4, nblocks = 3, n = block * nblocks, k = 5;
+	auto a = noarr::make_bag(noarr::scalar<double>() ^ noarr::vector<'k'>() ^ noarr::vector<'r'>() ^ noarr::set_length<'r', 'k'>(n, k));
+	auto c = noarr::make_bag(noarr::scalar<double>() ^ noarr::blocked_lower_triangle<'I', 'J', 'i', 'j', block>(nblocks));
+
+	REQUIRE((c | noarr::get_size()) == nblocks * (nblocks + 1) / 2 * block * block * sizeof(double));
+
+	noarr::traverser(a).for_each([&](auto state) {
+		a[state] = double(noarr::get_index<'r'>(state) % 5) - double(noarr::get_index<'k'>(state));
+	});
+
+	// C = A * A^T, one block at a time
+	noarr::traverser(c).for_each([&](auto state) {
+		std::size_t r = noarr::get_index<'I'>(state) * block + noarr::get_index<'i'>(state);
+		std::size_t s = noarr::get_index<'J'>(state) * block + noarr::get_index<'j'>(state);
+		double sum = 0;
+		for(std::size_t l = 0; l < k; l++)
+			sum += a.at<'r', 'k'>(r, l) * a.at<'r', 'k'>(s, l);
+		c[state] = sum;
+	});
+
+	for(std::size_t r = 0; r < n; r++) {
+		for(std::size_t s = 0; s <= r; s++) {
+			double sum = 0;
+			for(std::size_t l = 0; l < k; l++)
+				sum += a.at<'r', 'k'>(r, l) * a.at<'r', 'k'>(s, l);
+			REQUIRE(c.at<'I', 'J', 'i', 'j'>(r / block, s / block, r % block, s % block) == sum);
+		}
+	}
+}
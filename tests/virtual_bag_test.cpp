@@ -0,0 +1,85 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/gather.hpp>
+#include <noarr/structures/extra/reduce.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/interop/virtual_bag.hpp>
+
+TEST_CASE("Virtual bags in traversals", "[virtual_bag]") {
+	auto out = noarr::make_bag(noarr::scalar<double>() ^ noarr::sized_vectors<'x', 'y'>(10, 5));
+	auto iota = noarr::virtual_iota<'y', int>();
+	auto grid = noarr::virtual_grid<'x'>(-1.0, 0.25);
+	auto two = noarr::virtual_constant<'x', 'y'>(2.0);
+
+	// the virtual bags take their lengths from the real bag
+	std::size_t count = 0;
+	noarr::traverser(out, iota, grid, two).for_each([&](auto state) {
+		out[state] = iota[state] * grid[state] + two[state];
+		count++;
+	});
+	REQUIRE(count == 50);
+	for(std::size_t x = 0; x < 10; x++)
+		for(std::size_t y = 0; y < 5; y++)
+			REQUIRE(out.at<'x', 'y'>(x, y) == int(y) * (-1.0 + 0.25 * x) + 2.0);
+
+	REQUIRE(iota.at<'y'>(7) == 7);
+	REQUIRE(noarr::virtual_constant(3)[noarr::empty_state] == 3);
+
+	// the protos are applied to the indices before the generator sees them
+	auto shifted = iota ^ noarr::set_length<'y'>(20) ^ noarr::shift<'y'>(5);
+	REQUIRE((shifted | noarr::get_length<'y'>()) == 15);
+	REQUIRE(shifted.at<'y'>(0) == 5);
+	auto fixed = iota ^ noarr::set_length<'y'>(10) ^ noarr::fix<'y'>(4);
+	REQUIRE(fixed[noarr::empty_state] == 4);
+	auto renamed = grid ^ noarr::rename<'x', 't'>();
+	REQUIRE(renamed.at<'t'>(4) == 0.0);
+
+	auto custom = noarr::make_virtual_bag(noarr::scalar<int>() ^ noarr::sized_vectors<'x', 'y'>(10, 5), [](auto state) {
+		return int(noarr::get_index<'x'>(state) * 10 + noarr::get_index<'y'>(state));
+	});
+	REQUIRE((custom | noarr::get_length<'x'>()) == 10);
+	REQUIRE(custom.at<'x', 'y'>(3, 4) == 34);
+}
+
+TEST_CASE("Virtual bags in engines", "[virtual_bag]") {
+	auto matrix = noarr::scalar<float>() ^ noarr::sized_vectors<'j', 'i'>(100, 4);
+	auto random = noarr::virtual_random(matrix, 42);
+	auto sums = noarr::make_bag(noarr::scalar<float>() ^ noarr::sized_vector<'i'>(4));
+
+	noarr::reduce_along<'j'>(random, sums, noarr::reduce_sum());
+	for(std::size_t i = 0; i < 4; i++) {
+		float expected = 0;
+		for(std::size_t j = 0; j < 100; j++) {
+			float value = random.at<'i', 'j'>(i, j);
+			REQUIRE(value >= 0);
+			REQUIRE(value < 1);
+			expected += value;
+		}
+		REQUIRE(sums.at<'i'>(i) == expected);
+		REQUIRE(expected > 30);
+		REQUIRE(expected < 70);
+	}
+
+	// the values depend only on the element and the seed
+	REQUIRE(random.at<'i', 'j'>(2, 17) == noarr::virtual_random(matrix, 42).at<'i', 'j'>(2, 17));
+	REQUIRE(random.at<'i', 'j'>(2, 17) != random.at<'i', 'j'>(2, 18));
+	REQUIRE(random.at<'i', 'j'>(2, 17) != noarr::virtual_random(matrix, 43).at<'i', 'j'>(2, 17));
+	auto words = noarr::virtual_random(noarr::scalar<std::uint64_t>() ^ noarr::sized_vector<'i'>(2), 0);
+	REQUIRE(words.at<'i'>(0) != words.at<'i'>(1));
+
+	// virtual indices for a gather: reverse a vector
+	auto values = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'i'>(10));
+	auto reversed = noarr::make_bag(noarr::scalar<int>() ^ noarr::sized_vector<'i'>(10));
+	auto idx = noarr::make_virtual_bag(noarr::scalar<std::size_t>() ^ noarr::sized_vector<'i'>(10), [](auto state) {
+		return 9 - noarr::get_index<'i'>(state);
+	});
+	noarr::traverser(values).for_each([&](auto state) { values[state] = int(noarr::get_index<'i'>(state)); });
+	noarr::gather<'i'>(values, idx, reversed);
+	for(std::size_t i = 0; i < 10; i++)
+		REQUIRE(reversed.at<'i'>(i) == int(9 - i));
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <noarr/structures_extended.hpp>
+#include <noarr/structures/extra/traverser.hpp>
+#include <noarr/structures/interop/bag.hpp>
+#include <noarr/structures/structs/wrap.hpp>
+
+using noarr::lit;
+
+TEST_CASE("Wrap offsets", "[wrap]") {
+	auto ring = noarr::scalar<float>() ^ noarr::vector<'x'>() ^ noarr::ring<'t', 2>() ^ noarr::set_length<'x'>(10);
+	auto wrapped = noarr::scalar<float>() ^ noarr::vector<'x'>() ^ noarr::sized_vector<'t'>(noarr::fast_length(3)) ^ noarr::wrap<'t'>() ^ noarr::set_length<'x'>(10);
+
+	REQUIRE((ring | noarr::get_size()) == 2 * 10 * sizeof(float));
+	REQUIRE((wrapped | noarr::get_size()) == 3 * 10 * sizeof(float));
+
+	for(std::size_t t = 0; t < 20; t++) {
+		REQUIRE((ring | noarr::offset<'t', 'x'>(t, 4)) == ((t % 2) * 10 + 4) * sizeof(float));
+		REQUIRE((wrapped | noarr::offset<'t', 'x'>(t, 4)) == ((t % 3) * 10 + 4) * sizeof(float));
+	}
+
+	// static indices wrap at compile time
+	auto static_ring = noarr::scalar<float>() ^ noarr::array<'x', 10>() ^ noarr::ring<'t', 2>();
+	static_assert(decltype(static_ring | noarr::offset<'t', 'x'>(lit<5>, lit<3>))::value == 13 * sizeof(float));
+
+	// the logical length can be set for traversal
+	auto steps = ring ^ noarr::set_length<'t'>(7);
+	REQUIRE((steps | noarr::get_length<'t'>()) == 7);
+	std::size_t count = 0;
+	noarr::traverser(steps).for_each([&](auto state) {
+		REQUIRE((steps | noarr::offset(state)) == ((noarr::get_index<'t'>(state) % 2) * 10 + noarr::get_index<'x'>(state)) * sizeof(float));
+		count++;
+	});
+	REQUIRE(count == 70);
+}
+
+TEST_CASE("Wrap time steps", "[wrap]") {
+	constexpr std::size_t n = 16, steps = 5;
+	// two slots in memory, `steps + 1` logical time steps
+	auto grid = noarr::make_bag(noarr::scalar<int>() ^ noarr::vector<'x'>() ^ noarr::ring<'t', 2>() ^ noarr::set_length<'x', 't'>(n, steps + 1));
+	REQUIRE((grid | noarr::get_size()) == 2 * n * sizeof(int));
+
+	noarr::traverser(grid).order(noarr::fix<'t'>(0)).for_each([&](auto state) {
+		grid[state] = int(noarr::get_index<'x'>(state));
+	});
+	for(std::size_t t = 0; t < steps; t++) {
+		noarr::traverser(grid).order(noarr::fix<'t'>(t)).for_each([&](auto state) {
+			grid[state.template with<noarr::index_in<'t'>>(t + 1)] = grid[state] + 1;
+		});
+	}
+	for(std::size_t x = 0; x < n; x++)
+		REQUIRE(grid.at<'t', 'x'>(steps, x) == int(x + steps));
+}
+
+TEST_CASE("Wrap runs", "[wrap]") {
+	// a sliding window over a stream, the last 8 samples are kept
+	auto window = noarr::make_bag(noarr::scalar<int>() ^ noarr::ring<'s', 8>());
+	std::size_t seen = 0;
+
+	for(std::size_t chunk = 0; chunk < 5; chunk++) {
+		const std::size_t first = chunk * 5;
+		std::size_t runs = 0, total = 0;
+		noarr::wrap_for_each_run<'s'>(window, first, 5, [&](auto state, std::size_t length) {
+			int *ptr = &window[state];
+			for(std::size_t i = 0; i < length; i++)
+				ptr[i] = int(noarr::get_index<'s'>(state) + i);
+			REQUIRE(length <= 8 - noarr::get_index<'s'>(state) % 8);
+			runs++;
+			total += length;
+		});
+		REQUIRE(total == 5);
+		REQUIRE(runs == (first % 8 + 5 > 8 ? 2 : 1));
+		seen += 5;
+
+		for(std::size_t s = seen >= 8 ? seen - 8 : 0; s < seen; s++)
+			REQUIRE(window.at<'s'>(s) == int(s));
+	}
+}